@@ -0,0 +1,96 @@
+def RGBToWord(r,g,b):
+	rvalue=0
+	rvalue = rvalue + (g>>5)
+	rvalue = rvalue + ((g & 7)<< 13)
+	rvalue = rvalue + ((r>>3)<<8)
+	rvalue = rvalue + ((b >> 3) << 3)
+	return rvalue
+
+# Converts one or more bmp files into 4 bit palette images (PalImage in display.h).
+# All of the images share one palette of up to 16 colours.  Black is entry 0 and
+# is drawn as transparent by the tile renderer.  If the images use more than 15
+# other colours they are reduced with a small k-means pass.
+# usage: python bmptopal.py palette_name image1.bmp [image2.bmp ...]
+
+from PIL import Image
+from os import sys, path
+
+def unpack(w):
+	# RGBToWord back to 5/6/5 components
+	return ((w >> 8) & 0x1f, ((w & 7) << 3) | ((w >> 13) & 7), (w >> 3) & 0x1f)
+
+def pack(c):
+	r,g,b = c
+	return ((g >> 3) & 7) | ((g & 7) << 13) | (r << 8) | (b << 3)
+
+def distance(a,b):
+	# red and blue have half the resolution of green
+	return 4*(a[0]-b[0])**2 + (a[1]-b[1])**2 + 4*(a[2]-b[2])**2
+
+def nearest(c,centres):
+	return min(range(len(centres)), key=lambda i: distance(c,centres[i]))
+
+def quantise(counts,n):
+	# returns a map from each colour used to the colour that replaces it
+	colours=list(counts)
+	if len(colours) <= n:
+		return {w: w for w in colours}
+	rgb={w: unpack(w) for w in colours}
+	# start from the most common colour and keep adding the one worst served so far
+	centres=[rgb[max(colours, key=lambda w: counts[w])]]
+	while len(centres) < n:
+		worst=max(colours, key=lambda w: counts[w]*min(distance(rgb[w],c) for c in centres))
+		centres.append(rgb[worst])
+	for i in range(50):
+		groups=[[] for c in centres]
+		for w in colours:
+			groups[nearest(rgb[w],centres)].append(w)
+		moved=[]
+		for c,g in zip(centres,groups):
+			if len(g) == 0:
+				moved.append(c)
+				continue
+			total=sum(counts[w] for w in g)
+			moved.append(tuple(round(sum(rgb[w][k]*counts[w] for w in g)/total) for k in range(3)))
+		if moved == centres:
+			break
+		centres=moved
+	return {w: pack(centres[nearest(rgb[w],centres)]) for w in colours}
+
+def main():
+	args=sys.argv
+	if (len(args) < 3):
+		print("incorrect usage, please pass a palette name and the bmp files to program")
+		return -1
+	PaletteName=args[1]
+	images=[]
+	for ImageFileName in args[2:]:
+		im=Image.open(ImageFileName).convert('RGB')
+		pixels=[RGBToWord(px[0],px[1],px[2]) for px in im.getdata()]
+		name=path.splitext(path.basename(ImageFileName))[0]
+		images.append((name,im.size[0],im.size[1],pixels))
+	counts={}
+	for (name,w,h,pixels) in images:
+		for px in pixels:
+			if px != 0:
+				counts[px]=counts.get(px,0)+1
+	remap=quantise(counts,15)
+	# most used colours first, black always at index 0
+	uses={}
+	for px in counts:
+		uses[remap[px]]=uses.get(remap[px],0)+counts[px]
+	palette=[0]+sorted(uses, key=lambda c: -uses[c])
+	index={c: i for i,c in enumerate(palette)}
+	print("const uint16_t %s_palette[] = {%s};" % (PaletteName, ','.join(str(c) for c in palette)))
+	for (name,w,h,pixels) in images:
+		print("const uint8_t %s_pixels[] = {" % name)
+		for y in range(h):
+			row=[0 if px == 0 else index[remap[px]] for px in pixels[y*w:(y+1)*w]]
+			if (w & 1):
+				row.append(0)
+			print("\t" + ','.join('0x%02x' % ((row[x] << 4) | row[x+1]) for x in range(0,len(row),2)) + ',')
+		print("};")
+		print("const PalImage %s = {%d, %d, %s_palette, %s_pixels};" % (name, w, h, PaletteName, name))
+
+if __name__ == "__main__":
+	main()
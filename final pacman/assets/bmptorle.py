@@ -0,0 +1,63 @@
+def RGBToWord(r,g,b):
+	rvalue=0
+	rvalue = rvalue + (g>>5)
+	rvalue = rvalue + ((g & 7)<< 13)
+	rvalue = rvalue + ((r>>3)<<8)
+	rvalue = rvalue + ((b >> 3) << 3)
+	return rvalue
+
+# Converts a bmp file into a run length encoded image (RLEImage in display.h).
+# Packets are a count byte followed by colours stored low byte first:
+#   0x00-0x7f : 1 to 128 literal pixels
+#   0x80-0xff : a run of 1 to 128 pixels of one colour
+# usage: python bmptorle.py image.bmp
+
+from PIL import Image
+from os import sys, path
+
+def encode(pixels):
+	data=[]
+	literal=[]
+	def flush():
+		if len(literal) > 0:
+			data.append(len(literal)-1)
+			for px in literal:
+				data.extend([px & 0xff, px >> 8])
+			del literal[:]
+	i=0
+	while i < len(pixels):
+		run=1
+		while (i+run < len(pixels)) and (run < 128) and (pixels[i+run] == pixels[i]):
+			run=run+1
+		if run > 1:
+			# two equal pixels are already cheaper as a run (3 bytes instead of 4)
+			flush()
+			data.extend([0x80 | (run-1), pixels[i] & 0xff, pixels[i] >> 8])
+		else:
+			literal.append(pixels[i])
+			if len(literal) == 128:
+				flush()
+		i=i+run
+	flush()
+	return data
+
+def main():
+	args=sys.argv
+	if (len(args) != 2):
+		print("incorrect usage, please pass name of bmp to program")
+		return -1
+
+	ImageFileName=args[1]
+	im=Image.open(ImageFileName).convert('RGB')
+	pixels=[RGBToWord(px[0],px[1],px[2]) for px in im.getdata()]
+	name=path.splitext(path.basename(ImageFileName))[0]
+	data=encode(pixels)
+	print("// %s: %d x %d, %d bytes (%d raw)" % (name, im.size[0], im.size[1], len(data), 2*len(pixels)))
+	print("const uint8_t %s_rle[] = {" % name)
+	for i in range(0,len(data),16):
+		print("\t" + ','.join('0x%02x' % b for b in data[i:i+16]) + ',')
+	print("};")
+	print("const RLEImage %s = {%d, %d, %s_rle};" % (name, im.size[0], im.size[1], name))
+
+if __name__ == "__main__":
+	main()
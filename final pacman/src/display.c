@@ -1,625 +1,1550 @@
-#include <stm32f031x6.h>
-#include "font5x7.h"
-#include "display.h"
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 160
-
-
-
-void clear(void);
-static uint32_t mystrlen(const char *s);
-static void drawLineLowSlope(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1, uint16_t Colour);
-static void drawLineHighSlope(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1, uint16_t Colour);
-static int iabs(int x);
-static void openAperture(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
-static void CSLow(void);
-static void CSHigh(void);
-static void DCLow(void);
-static void DCHigh(void);
-static void initSPI(void);
-static uint8_t transferSPI8(uint8_t data);
-static uint16_t transferSPI16(uint16_t data);
-static void command(uint8_t cmd);
-static void data(uint8_t data);
-static void ResetLow(void);
-static void ResetHigh(void);
-
-
-
-
-void display_begin()
-{
-
-	RCC->AHBENR |= (1 << 17);  // Turn on GPIO A
-	// Configure PA3 for Reset pin
-	GPIOA->MODER |= (1 << 6);
-	GPIOA->MODER &= ~(1u << 7);
-	// Configure PA4 for CS pin
-	GPIOA->MODER |= (1 << 8);
-	GPIOA->MODER &= ~(1u << 9);
-	// Configure PA6 for D/C pin
-	GPIOA->MODER |= (1 << 12);
-	GPIOA->MODER &= ~(1u << 13);
-	initSPI();
-	//  hw_test();
-	// Lots of CS toggling here seems to have made the boot up more reliable
-	CSHigh();
-	ResetHigh();	
-	delay(10);
-	ResetLow();
-	delay(200);
-	ResetHigh();
-	CSHigh();
-	delay(200);
-	CSLow();
-	delay(20);
-	command(0x01); // software reset
-	delay(100);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x11); // exit sleep
-	delay(120);
-	// set frame rate
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb1);
-	data(0x05);
-	data(0x3c);
-	data(0x3c);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb2);
-	data(0x05);
-	data(0x3c);
-	data(0x3c);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb3);
-	data(0x05);
-	data(0x3c);
-	data(0x3c);	
-	data(0x05);
-	data(0x3c);
-	data(0x3c);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb4); // dot invert
-	data(0x03);
-	CSHigh();
-	delay(1);			
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x36);// Set pixel and RGB order
-	data(0x08); 	
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);		
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x3a);// Set colour mode        
-	data(0x5); 	
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x29);    // display on
-	delay(100);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x2c);   // put display in to write mode
-
-	fillRectangle(0,0,SCREEN_WIDTH, SCREEN_HEIGHT, 0x0);  // black out the screen
-}
-void ResetLow()
-{
-	GPIOA->ODR &= ~(1u << 3);
-}
-void ResetHigh()
-{
-	GPIOA->ODR |= (1 << 3);
-}
-void CSLow()
-{
-	GPIOA->ODR &= ~(1u << 4);
-}
-void CSHigh()
-{
-	GPIOA->ODR |= (1 << 4);
-}
-void DCLow()
-{
-	GPIOA->ODR &= ~(1u << 6);
-}
-void DCHigh()
-{
-	GPIOA->ODR |= (1 << 6);
-}
-void initSPI(void)
-{
-	uint32_t  drain_count,drain;
-	
-	RCC->APB2ENR |= (1 << 12);		// turn on SPI1 	
-	
-	
-	// GPIOA bits 5 and 7 are used for SPI1 (Alternative functions 0)
-    GPIOA->MODER &= ~( (1u << 14)+(1u << 10)); // select Alternative function
-    GPIOA->MODER |= ((1 << 15)+(1 << 11));  // for bits 5,7 (not using MISO)
-    GPIOA->AFR[0] &= 0x000fffff;		     // select Alt. Function 0
-	
-	// Now configure the SPI interface	
-	drain = SPI1->SR;				// dummy read of SR to clear MODF	
-	// enable SSM, set SSI, enable SPI, PCLK/2, MSB First Master, Clock = 1 when idle
-	SPI1->CR1 = (1 << 9)+(1 << 8)+(1 << 6)+(1 << 2) +(1 << 1) + (1 << 0); // Might get away with removing bit 3 here and get 24MHz clock
-	SPI1->CR2 = (1 << 10)+(1 << 9)+(1 << 8); 	// configure for 8 bit operation
-   
-  for (drain_count = 0; drain_count < 32; drain_count++)
-	drain = transferSPI8((uint8_t)0x00);
-}
-
-uint8_t transferSPI8(uint8_t data)
-{
-    unsigned Timeout = 1000000;
-    uint8_t ReturnValue;
-    volatile uint8_t *preg=(volatile uint8_t*)&SPI1->DR;
-	
-    while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));
-    *preg = data;
-    Timeout = 1000000;
-    while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));        
-	  ReturnValue = *preg;	
-    return ReturnValue;
-}
-
-uint16_t transferSPI16(uint16_t data)
-{
-    unsigned Timeout = 1000000;
-    uint32_t ReturnValue;    
-	
-    while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));
-    SPI1->DR = data;
-    Timeout = 1000000;
-    while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));        
-	  ReturnValue = SPI1->DR;
-	
-    return (uint16_t)ReturnValue;
-}
-void command(uint8_t cmd)
-{
-	DCLow();
-	transferSPI8(cmd);
-}
-
-void data(uint8_t data)
-{
-	DCHigh();
-	transferSPI8(data);
-}
-
-
-void openAperture(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
-{
-    // open up an area for drawing on the display    
-
-	command(0x2A); // Set X limits    	
-    data(x1>>8);
-    data(x1&0xff);        
-    data(x2>>8);
-    data(x2&0xff);
-    
-    command(0x2B);// Set Y limits
-    data(y1>>8);
-    data(y1&0xff);        
-    data(y2>>8);
-    data(y2&0xff);    
-        
-    command(0x2c); // put display in to data write mode
-	
-}
-void fillRectangle(uint16_t x,uint16_t y,uint16_t width, uint16_t height, uint16_t colour)
-{
-	uint32_t pixelcount = height * width;
-	openAperture(x, y, x + width - 1, y + height - 1);
-	DCHigh();
-	while(pixelcount--) 
-	{
-		transferSPI16(colour);
-	}	
-}
-void putPixel(uint16_t x, uint16_t y, uint16_t colour)
-{
-	openAperture(x, y, x + 1, y + 1);	
-	DCHigh();
-	transferSPI16(colour);
-}
-void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation)
-{
-    uint16_t Colour;
-	  uint32_t offset = 0;
-    openAperture(x, y, x + width - 1, y + height - 1);
-    DCHigh();
-	  if (hOrientation == 0)
-		{
-			if (vOrientation == 0)
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=y*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+x];
-								transferSPI16(Colour);
-						}
-				}
-			}
-			else
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=(height-(y+1))*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+x];
-								transferSPI16(Colour);
-						}
-				}
-			}
-		}
-		else
-		{
-			if (vOrientation == 0)
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=y*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+(width-x-1)];
-								transferSPI16(Colour);
-						}
-				}
-			}
-			else
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=(height-(y+1))*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+(width-x-1)];
-								transferSPI16(Colour);
-						}
-				}
-			}
-		}
-}
-void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t Colour)
-{
-	// Reference : https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm    
-    if ( iabs(y1 - y0) < iabs(x1 - x0) )
-    {
-        if (x0 > x1)
-        {
-            drawLineLowSlope(x1, y1, x0, y0, Colour);
-        }
-        else
-        {
-            drawLineLowSlope(x0, y0, x1, y1, Colour);
-        }
-    }
-    else
-    {
-        if (y0 > y1) 
-        {
-            drawLineHighSlope(x1, y1, x0, y0, Colour);
-        }
-        else
-        {
-            drawLineHighSlope(x0, y0, x1, y1, Colour);
-        }
-        
-    }    
-}
-int iabs(int x) // simple integer version of abs for use by graphics functions        
-{
-	if (x < 0)
-		x = -x;
-	return x;
-}
-void drawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Colour)
-{
-	drawLine(x,y,x+w,y,Colour);
-  drawLine(x,y,x,y+h,Colour);
-  drawLine(x+w,y,x+w,y+h,Colour);
-  drawLine(x,y+h,x+w,y+h,Colour);
-}
-void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour)
-{
-// Reference : https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
-    uint16_t x = radius-1;
-    uint16_t y = 0;
-    int dx = 1;
-    int dy = 1;
-    int err = dx - (radius << 1);
-    if (radius > x0)
-        return; // don't draw even parially off-screen circles
-    if (radius > y0)
-        return; // don't draw even parially off-screen circles
-        
-    if ((x0+radius) > SCREEN_WIDTH)
-        return; // don't draw even parially off-screen circles
-    if ((y0+radius) > SCREEN_HEIGHT)
-        return; // don't draw even parially off-screen circles    
-    while (x >= y)
-    {
-        putPixel(x0 + x, y0 + y, Colour);
-        putPixel(x0 + y, y0 + x, Colour);
-        putPixel(x0 - y, y0 + x, Colour);
-        putPixel(x0 - x, y0 + y, Colour);
-        putPixel(x0 - x, y0 - y, Colour);
-        putPixel(x0 - y, y0 - x, Colour);
-        putPixel(x0 + y, y0 - x, Colour);
-        putPixel(x0 + x, y0 - y, Colour);
-
-        if (err <= 0)
-        {
-            y++;
-            err += dy;
-            dy += 2;
-        }
-        
-        if (err > 0)
-        {
-            x--;
-            dx += 2;
-            err += dx - (radius << 1);
-        }
-    }
-}
-void fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour)
-{
-	// Reference : https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
-	// Similar to drawCircle but fills the circle with lines instead
-    uint16_t x = radius-1;
-    uint16_t y = 0;
-    int dx = 1;
-    int dy = 1;
-    int err = dx - (radius << 1);
-
-    if (radius > x0)
-        return; // don't draw even parially off-screen circles
-    if (radius > y0)
-        return; // don't draw even parially off-screen circles
-        
-    if ((x0+radius) > SCREEN_WIDTH)
-        return; // don't draw even parially off-screen circles
-    if ((y0+radius) > SCREEN_HEIGHT)
-        return; // don't draw even parially off-screen circles        
-    while (x >= y)
-    {
-        drawLine(x0 - x, y0 + y,x0 + x, y0 + y, Colour);        
-        drawLine(x0 - y, y0 + x,x0 + y, y0 + x, Colour);        
-        drawLine(x0 - x, y0 - y,x0 + x, y0 - y, Colour);        
-        drawLine(x0 - y, y0 - x,x0 + y, y0 - x, Colour);        
-
-        if (err <= 0)
-        {
-            y++;
-            err += dy;
-            dy += 2;
-        }
-        
-        if (err > 0)
-        {
-            x--;
-            dx += 2;
-            err += dx - (radius << 1);
-        }
-    }
-}
-void printText(const char *Text,uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
-{
-	// This function draws each character individually.  It uses an array called TextBox as a temporary storage
-    // location to hold the dots for the character in question.  It constructs the image of the character and then
-    // calls on putImage to place it on the screen
-    uint8_t Index = 0;
-    uint8_t Row, Col;
-    const uint8_t *CharacterCode = 0;    
-    uint16_t TextBox[FONT_WIDTH * FONT_HEIGHT];
-	uint16_t len;
-	len=(uint16_t) mystrlen(Text);
-    for (Index = 0; Index < len; Index++)
-    {
-        CharacterCode = &Font5x7[FONT_WIDTH * (Text[Index] - 32)];
-        Col = 0;
-        while (Col < FONT_WIDTH)
-        {
-            Row = 0;
-            while (Row < FONT_HEIGHT)
-            {
-                if (CharacterCode[Col] & (1 << Row))
-                {
-                    TextBox[(Row * FONT_WIDTH) + Col] = ForeColour;
-                }
-                else
-                {
-                    TextBox[(Row * FONT_WIDTH) + Col] = BackColour;
-                }
-                Row++;
-            }
-            Col++;
-        }
-        putImage(x, y, FONT_WIDTH, FONT_HEIGHT, (uint16_t *)TextBox,0,0);
-        x = x + FONT_WIDTH + 2;
-    }
-}
-void printTextX2(const char *Text, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
-{
-	#define Scale 2
-	// This function draws each character individually scaled up by a factor of 2.  It uses an array called TextBox as a temporary storage
-    // location to hold the dots for the character in question.  It constructs the image of the character and then
-    // calls on putImage to place it on the screen
-    uint8_t Index = 0;
-    uint8_t Row, Col;
-    const uint8_t *CharacterCode = 0;    
-	uint16_t len;
-	len=(uint16_t)mystrlen(Text);
-    uint16_t TextBox[FONT_WIDTH * FONT_HEIGHT*Scale * Scale];
-
-    for (Index = 0; Index < len; Index++)
-    {
-        CharacterCode = &Font5x7[FONT_WIDTH * (Text[Index] - 32)];
-        Col = 0;
-        while (Col < FONT_WIDTH)
-        {
-            Row = 0;
-            while (Row < FONT_HEIGHT)
-            {
-                if (CharacterCode[Col] & (1 << Row))
-                {
-                    TextBox[((Row*Scale) * FONT_WIDTH*Scale) + (Col*Scale)] = ForeColour;
-					TextBox[((Row*Scale) * FONT_WIDTH*Scale) + (Col*Scale)+1] = ForeColour;
-					TextBox[(((Row*Scale)+1) * FONT_WIDTH*Scale) + (Col*Scale)] = ForeColour;
-					TextBox[(((Row*Scale)+1) * FONT_WIDTH*Scale) + (Col*Scale)+1] = ForeColour;
-                }
-                else
-                {
-                    TextBox[((Row*Scale) * FONT_WIDTH*Scale) + (Col*Scale)] = BackColour;
-					TextBox[((Row*Scale) * FONT_WIDTH*Scale) + (Col*Scale)+1] = BackColour;
-					TextBox[(((Row*Scale)+1) * FONT_WIDTH*Scale) + (Col*Scale)] = BackColour;
-					TextBox[(((Row*Scale)+1) * FONT_WIDTH*Scale) + (Col*Scale)+1] = BackColour;
-                }
-                Row++;
-            }
-            Col++;
-        }
-        putImage(x, y, FONT_WIDTH*Scale, FONT_HEIGHT*Scale, (uint16_t *)TextBox,0,0);
-        x = x + FONT_WIDTH*Scale + 2;
-    }
-}
-void printNumber(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
-{
-	// This function converts the supplied number into a character string and then calls on puText to
-    // write it to the display
-    char Buffer[6]; // Maximum value = 65535
-    Buffer[5]=0;
-    Buffer[4] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[3] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[2] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[1] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[0] = Number % 10 + '0';
-    printText(Buffer, x, y, ForeColour, BackColour);
-}
-void printNumberX2(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
-{
-     // This function converts the supplied number into a character string and then calls on puText to
-    // write it to the display
-    char Buffer[6]; // Maximum value = 65535
-    Buffer[5]=0;
-    Buffer[4] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[3] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[2] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[1] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[0] = Number % 10 + '0';
-    printTextX2(Buffer, x, y, ForeColour, BackColour);	
-}
-uint16_t RGBToWord(uint16_t R, uint16_t G, uint16_t B)
-{
-	uint16_t rvalue = 0;
-    rvalue += G >> 5;
-    rvalue += (G & (7)) << 13;
-    rvalue += (R >> 3) << 8;
-    rvalue += (B >> 3) << 3;
-    return rvalue;
-}
-void drawLineLowSlope(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1, uint16_t Colour)
-{
-   // Reference : https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm    
-  int dx = x1 - x0;
-  int dy = y1 - y0;
-  int yi = 1;
-  if (dy < 0)
-  {
-    yi = -1;
-    dy = -dy;
-  }
-  int D = 2*dy - dx;
-  
-  int y = y0;
-
-  for (int x=x0; x <= x1;x++)
-  {
-    putPixel((uint16_t)x,(uint16_t)y,Colour);    
-    if (D > 0)
-    {
-       y = y + yi;
-       D = D - 2*dx;
-    }
-    D = D + 2*dy;
-    
-  }
-}
-void drawLineHighSlope(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1, uint16_t Colour)
-{
-  // Reference : https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
-  int dx = x1 - x0;
-  int dy = y1 - y0;
-  int xi = 1;
-  if (dx < 0)
-  {
-    xi = -1;
-    dx = -dx;
-  }  
-  int D = 2*dx - dy;
-  int x = x0;
-
-  for (int y=y0; y <= y1; y++)
-  {
-    putPixel((uint16_t)x,(uint16_t)y,Colour);
-    if (D > 0)
-    {
-       x = x + xi;
-       D = D - 2*dy;
-    }
-    D = D + 2*dx;
-  }
-}
-void clear()
-{
-	fillRectangle(0,0,SCREEN_WIDTH, SCREEN_HEIGHT, 0x0000);  // black out the screen
-}
-uint32_t mystrlen(const char *s)
-{
-	uint32_t len=0;
-	while(*s)
-	{
-		s++;
-		len++;
-	}
-	return len;
-}
-
+#include <stm32f031x6.h>
+#include "display.h"      // before the fonts: font5x7.h leaves #pragma pack(1) in force
+#include "font5x7.h"
+#include "font5x7rows.h"
+#ifdef DISPLAY_ILI9341
+#define FRAME_ROWS 320        // rows of frame memory, all of them shown
+#else
+#define FRAME_ROWS 162        // rows of frame memory, the panel shows the first PANEL_HEIGHT
+#endif
+#define LINE_BUFFER_SIZE 32   // pixels per DMA line buffer (two are used in turn)
+#define DMA_MIN_PIXELS 32     // shorter runs are sent by the CPU, setting up the DMA costs more
+#define BAND_ROWS 2           // rows per composeArea band
+#if DISPLAY_SCALE > 1
+#define BAND_BUFFERS 1        // sendPixel copies each band out before the next is built
+#else
+#define BAND_BUFFERS 2        // one is built while the DMA sends the other
+#endif
+
+
+
+void clear(void);
+static uint8_t nextGlyph(const char **Text);
+static uint16_t countGlyphs(const char *Text);
+static void drawLineLowSlope(int x0, int y0, int x1, int y1, uint16_t Colour);
+static void drawLineHighSlope(int x0, int y0, int x1, int y1, uint16_t Colour);
+static int iabs(int x);
+static int ellipseHalfWidth(int rx, int ry, int dy);
+static void fillSpan(int x0, int x1, int y, uint16_t Colour);
+static int clipArea(uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h, uint16_t *SkipX, uint16_t *SkipY);
+static void composeLayer(const Layer *L, uint16_t *Row, uint16_t x, uint16_t w, uint16_t y);
+static void composeSpan(uint16_t *Row, uint16_t x, uint16_t w, uint16_t From, uint16_t n, uint16_t Colour);
+static void configure(void);
+static void CSLow(void);
+static void CSHigh(void);
+static void DCLow(void);
+static void DCHigh(void);
+static void initSPI(void);
+static uint8_t transferSPI8(uint8_t data);
+static void command(uint8_t cmd);
+static void data(uint8_t data);
+static void ResetLow(void);
+static void ResetHigh(void);
+static void startDMA(const uint16_t *src, uint16_t count, int increment);
+static void streamPixels(const uint16_t *src, uint32_t count);
+static void finishSPI(void);
+static void sendPixel(uint16_t colour);
+static void sendWord(uint16_t colour);
+static void sendPixels(const uint16_t *src, uint32_t count);
+static void sendReversed(const uint16_t *src, uint16_t count);
+static void sendFill(uint16_t colour, uint32_t count);
+static void sendRun(uint16_t colour, uint32_t count);
+#if DISPLAY_SCALE > 1
+static void sendRow(void);
+#endif
+static void endPixels(void);
+
+static uint16_t FillColour;  // DMA source word for solid fills
+// Driver state cache: the last CASET/RASET window sent and the level of the D/C pin.
+// Commands that would not change anything are skipped.
+#define WINDOW_UNKNOWN 0xffff
+#define DC_UNKNOWN 2
+static uint16_t WinX1 = WINDOW_UNKNOWN, WinX2, WinY1 = WINDOW_UNKNOWN, WinY2;
+static uint8_t DCState = DC_UNKNOWN;
+static uint16_t ScrollLine;  // frame memory row shown at the top of the scrolling area
+// Power up sequence, see display_poll
+#define INIT_RESET 0      // reset pin held low
+#define INIT_WAKE 1       // out of reset, waiting to send sleep out
+#define INIT_CONFIGURE 2  // sleep out sent, waiting to configure
+#define INIT_READY 3
+static uint8_t InitState;
+static uint32_t InitSince;  // time the current step started
+// Panel power modes, see display_setIdle etc.
+static uint8_t IdleOn, PartialOn, Asleep;  // Asleep is 2 from sleep out until it is done
+static uint32_t SleepSince;  // time of the last sleep in or sleep out
+static uint16_t PartialTop = WINDOW_UNKNOWN, PartialBottom;  // rows last sent with PTLAR
+// Clip rectangle, see display_setClip: drawing is limited to ClipX0 <= x < ClipX1
+// and ClipY0 <= y < ClipY1
+static int16_t ClipX0 = 0, ClipY0 = 0, ClipX1 = SCREEN_WIDTH, ClipY1 = SCREEN_HEIGHT;
+static DisplayStats Stats;
+static uint16_t LineBuffer[2][LINE_BUFFER_SIZE];  // DMA sources for mirrored image rows
+static uint16_t BandBuffer[BAND_BUFFERS][BAND_ROWS * SCREEN_WIDTH];  // DMA sources for composeArea
+#if DISPLAY_SCALE > 1
+// Scaled drawing: openAperture opens the panel window under the scaled area and
+// sendPixel collects each row of the aperture, every pixel repeated DISPLAY_SCALE
+// times.  sendRow then has the DMA send the row DISPLAY_SCALE times while the next
+// one is collected in the other buffer.
+#define SCALE_OFFSET ((PANEL_WIDTH - SCREEN_WIDTH * DISPLAY_SCALE) / 2)  // panel column of screen column 0
+#define SCALE_X0 ((DISPLAY_SCALE - 1 - SCALE_OFFSET) / DISPLAY_SCALE)    // first screen column on the panel
+#define SCALE_X1 ((PANEL_WIDTH - SCALE_OFFSET) / DISPLAY_SCALE)          // and one past the last
+static uint16_t ScaleBuffer[2][PANEL_WIDTH];
+static uint16_t *ScaleOut;           // where the next pixel of the row goes
+static uint8_t ScaleBuf;             // ScaleBuffer being filled
+static uint16_t ScaleCol;            // aperture column of the next pixel
+static uint16_t ScaleWidth;          // aperture width
+static uint16_t ScaleSkip;           // aperture columns left of the panel
+static uint16_t ScaleVisible;        // aperture columns on the panel
+static uint16_t ScaleRows;           // aperture rows still to come
+static const uint16_t *RepeatSrc;    // row the DMA still has to send again
+static uint16_t RepeatCount;
+static uint8_t RepeatsLeft;
+#endif
+
+
+
+
+void display_begin()
+{
+	// Blocking start up, for when there is nothing else to do in the meantime
+	uint32_t Now = 0;
+	display_start(Now);
+	while (display_poll(Now) == 0)
+	{
+		delay(1);
+		Now++;
+	}
+}
+void display_start(uint32_t Now)
+{
+	// Begin the power up sequence: set up the pins and SPI and hold the panel in
+	// reset.  display_poll carries on from here as time passes.
+	RCC->AHBENR |= (1 << 17);  // Turn on GPIO A
+	// Configure PA3 for Reset pin
+	GPIOA->MODER |= (1 << 6);
+	GPIOA->MODER &= ~(1u << 7);
+	// Configure PA4 for CS pin
+	GPIOA->MODER |= (1 << 8);
+	GPIOA->MODER &= ~(1u << 9);
+	// Configure PA6 for D/C pin
+	GPIOA->MODER |= (1 << 12);
+	GPIOA->MODER &= ~(1u << 13);
+	initSPI();
+	display_invalidate();
+	DCState = DC_UNKNOWN;
+	IdleOn = PartialOn = Asleep = 0;  // the reset puts the panel back to normal mode
+	PartialTop = WINDOW_UNKNOWN;
+	CSHigh();
+	ResetLow();
+	InitState = INIT_RESET;
+	InitSince = Now;
+}
+int display_poll(uint32_t Now)
+{
+	// Advance the power up sequence, returns 1 once the display can be drawn on.
+	// Now is a millisecond count; each wait is one tick longer than the datasheet
+	// minimum because the first tick may come straight away.
+	switch (InitState)
+	{
+		case INIT_RESET:
+			// the reset pulse only has to be 10us long
+			if (Now - InitSince < 2)
+				return 0;
+			ResetHigh();
+			InitState = INIT_WAKE;
+			InitSince = Now;
+			return 0;
+		case INIT_WAKE:
+			// 120ms after a reset before sleep out is accepted
+			if (Now - InitSince < 121)
+				return 0;
+			CSLow();
+			command(0x11); // exit sleep
+			InitState = INIT_CONFIGURE;
+			InitSince = Now;
+			return 0;
+		case INIT_CONFIGURE:
+			// 5ms after sleep out before any other command
+			if (Now - InitSince < 6)
+				return 0;
+			configure();
+			InitState = INIT_READY;
+			return 1;
+		default:
+			return 1;
+	}
+}
+int display_ready()
+{
+	return (InitState == INIT_READY);
+}
+void configure()
+{
+	// Everything after sleep out.  CS is raised between commands; this seems to
+	// have made boot up more reliable on some panels.
+#ifdef DISPLAY_ILI9341
+	command(0xc0); // power control 1: GVDD 4.6V
+	data(0x23);
+	CSHigh();
+	CSLow();
+	command(0xc1); // power control 2: step up factor
+	data(0x10);
+	CSHigh();
+	CSLow();
+	command(0xc5); // VCOM control 1
+	data(0x3e);
+	data(0x28);
+	CSHigh();
+	CSLow();
+	command(0xc7); // VCOM control 2
+	data(0x86);
+	CSHigh();
+	CSLow();
+	command(0xb1); // set frame rate: 79Hz
+	data(0x00);
+	data(0x18);
+	CSHigh();
+	CSLow();
+	command(0xb6); // display function control: 320 lines
+	data(0x08);
+	data(0x82);
+	data(0x27);
+	CSHigh();
+	CSLow();
+	command(0x26); // gamma curve 1
+	data(0x01);
+	CSHigh();
+	CSLow();
+	command(0x36);// Set pixel and RGB order, most modules have their columns wired right to left
+	data(0x48);
+	CSHigh();
+	CSLow();
+#else
+	command(0xb1); // set frame rate
+	data(0x05);
+	data(0x3c);
+	data(0x3c);
+	CSHigh();
+	CSLow();
+	command(0xb2);
+	data(0x05);
+	data(0x3c);
+	data(0x3c);
+	CSHigh();
+	CSLow();
+	command(0xb3);
+	data(0x05);
+	data(0x3c);
+	data(0x3c);	
+	data(0x05);
+	data(0x3c);
+	data(0x3c);
+	CSHigh();
+	CSLow();
+	command(0xb4); // dot invert
+	data(0x03);
+	CSHigh();
+	CSLow();
+	command(0x36);// Set pixel and RGB order
+	data(0x08); 	
+	CSHigh();
+	CSLow();
+#endif
+	command(0x3a);// Set colour mode        
+	data(0x5); 	
+	CSHigh();
+	CSLow();
+	display_setScrollArea(0, SCREEN_HEIGHT);
+	// black out the screen before turning it on so that nothing random is shown
+	fillRectangle(0,0,SCREEN_WIDTH, SCREEN_HEIGHT, 0x0);
+	command(0x29);    // display on
+}
+void ResetLow()
+{
+	GPIOA->ODR &= ~(1u << 3);
+}
+void ResetHigh()
+{
+	GPIOA->ODR |= (1 << 3);
+}
+void CSLow()
+{
+	GPIOA->ODR &= ~(1u << 4);
+}
+void CSHigh()
+{
+	GPIOA->ODR |= (1 << 4);
+}
+void DCLow()
+{
+	if (DCState != 0)
+	{
+		GPIOA->ODR &= ~(1u << 6);
+		DCState = 0;
+	}
+}
+void DCHigh()
+{
+	if (DCState != 1)
+	{
+		GPIOA->ODR |= (1 << 6);
+		DCState = 1;
+	}
+}
+void initSPI(void)
+{
+	uint32_t  drain_count,drain;
+	
+	RCC->APB2ENR |= (1 << 12);		// turn on SPI1 	
+	RCC->AHBENR |= (1 << 0);		// turn on DMA1 (channel 3 services SPI1_TX)
+	
+	
+	// GPIOA bits 5 and 7 are used for SPI1 (Alternative functions 0)
+    GPIOA->MODER &= ~( (1u << 14)+(1u << 10)); // select Alternative function
+    GPIOA->MODER |= ((1 << 15)+(1 << 11));  // for bits 5,7 (not using MISO)
+    GPIOA->AFR[0] &= 0x000fffff;		     // select Alt. Function 0
+	
+	// Now configure the SPI interface	
+	drain = SPI1->SR;				// dummy read of SR to clear MODF	
+	// enable SSM, set SSI, enable SPI, PCLK/2, MSB First Master, Clock = 1 when idle
+	SPI1->CR1 = (1 << 9)+(1 << 8)+(1 << 6)+(1 << 2) +(1 << 1) + (1 << 0); // Might get away with removing bit 3 here and get 24MHz clock
+	SPI1->CR2 = (1 << 10)+(1 << 9)+(1 << 8); 	// configure for 8 bit operation
+   
+  for (drain_count = 0; drain_count < 32; drain_count++)
+	drain = transferSPI8((uint8_t)0x00);
+}
+
+uint8_t transferSPI8(uint8_t data)
+{
+    unsigned Timeout = 1000000;
+    uint8_t ReturnValue;
+    volatile uint8_t *preg=(volatile uint8_t*)&SPI1->DR;
+	
+    while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));
+    *preg = data;
+    Timeout = 1000000;
+    while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));        
+	  ReturnValue = *preg;	
+    return ReturnValue;
+}
+
+void startDMA(const uint16_t *src, uint16_t count, int increment)
+{
+	// Hand count 16 bit words over to DMA1 channel 3 (SPI1_TX).  The SPI stays in 8 bit mode:
+	// each 16 bit write to DR is packed as two frames, low byte first, exactly as sendPixel does.
+	DMA1_Channel3->CCR = 0;				// channel must be disabled while it is set up
+	DMA1->IFCR = (1 << 8);				// clear all channel 3 flags
+	DMA1_Channel3->CPAR = (uint32_t)&SPI1->DR;
+	DMA1_Channel3->CMAR = (uint32_t)src;
+	DMA1_Channel3->CNDTR = count;
+	// 16 bit memory and peripheral size, memory to peripheral
+	DMA1_Channel3->CCR = (1 << 10) + (1 << 8) + (1 << 4);
+	if (increment)
+		DMA1_Channel3->CCR |= (1 << 7);	// step through the source, otherwise repeat one word
+	SPI1->CR2 |= (1 << 1);				// let SPI1 request data from the DMA
+	DMA1_Channel3->CCR |= (1 << 0);		// and go
+}
+int display_busy(void)
+{
+	// Non zero while a DMA transfer is still feeding the SPI
+	int Busy = ((DMA1_Channel3->CCR & (1 << 0)) != 0) && ((DMA1->ISR & (1 << 9)) == 0);
+#if DISPLAY_SCALE > 1
+	if ((Busy == 0) && RepeatsLeft)
+	{
+		// start the next copy of a scaled row here, so polling keeps the SPI busy
+		RepeatsLeft--;
+		startDMA(RepeatSrc, RepeatCount, 1);
+		Busy = 1;
+	}
+#endif
+	return Busy;
+}
+void display_wait(void)
+{
+	// Wait until every pixel handed to the DMA has left the SPI
+	unsigned Timeout = 1000000;
+
+	if (DMA1_Channel3->CCR & (1 << 0))
+	{
+		while (((DMA1->ISR & (1 << 9))==0)&&(Timeout--));	// transfer complete
+#if DISPLAY_SCALE > 1
+		while (RepeatsLeft)
+		{
+			// the other copies of a scaled row, see sendRow
+			RepeatsLeft--;
+			startDMA(RepeatSrc, RepeatCount, 1);
+			Timeout = 1000000;
+			while (((DMA1->ISR & (1 << 9))==0)&&(Timeout--));
+		}
+#endif
+		DMA1_Channel3->CCR = 0;
+		DMA1->IFCR = (1 << 8);
+		SPI1->CR2 &= ~(1u << 1);
+		finishSPI();
+	}
+}
+void finishSPI(void)
+{
+	// Let the TX FIFO run dry and the last frame shift out.  The display never
+	// talks back, so whatever collected in the receive FIFO meanwhile is thrown away.
+	unsigned Timeout = 1000000;
+	volatile uint8_t *preg=(volatile uint8_t*)&SPI1->DR;
+	uint8_t drain;
+
+	while (((SPI1->SR & (3u << 11))!=0)&&(Timeout--));	// TX FIFO empty
+	Timeout = 1000000;
+	while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));	// last frame shifted out
+	while ((SPI1->SR & (3u << 9))!=0)					// empty the RX FIFO
+		drain = *preg;
+	drain = (uint8_t)SPI1->SR;							// and clear any overrun
+	(void)drain;
+}
+void streamPixels(const uint16_t *src, uint32_t count)
+{
+	// DMA count consecutive pixels starting at src.  The last block is left running.
+	uint16_t block;
+	while (count)
+	{
+		block = (count > 0xffff) ? 0xffff : (uint16_t)count;
+		display_wait();
+		startDMA(src, block, 1);
+		src += block;
+		count -= block;
+	}
+}
+void sendPixel(uint16_t colour)
+{
+#if DISPLAY_SCALE > 1
+	// Add one pixel to the aperture row, dropping those that are off the panel
+	uint16_t k;
+	if ((uint16_t)(ScaleCol - ScaleSkip) < ScaleVisible)
+	{
+		for (k = 0; k < DISPLAY_SCALE; k++)
+			*ScaleOut++ = colour;
+	}
+	if (++ScaleCol == ScaleWidth)
+		sendRow();
+#else
+	sendWord(colour);
+#endif
+}
+void sendWord(uint16_t colour)
+{
+	// Queue one pixel as soon as there is room in the TX FIFO.  A 16 bit write is
+	// packed into two 8 bit frames which go out back to back, low byte first.
+	while ((SPI1->SR & (1 << 1))==0);	// TXE
+	SPI1->DR = colour;
+}
+#if DISPLAY_SCALE > 1
+void sendRow(void)
+{
+	// The aperture row collected by sendPixel is complete: it goes out DISPLAY_SCALE
+	// times, the copies after the first are started by display_wait or display_busy
+	uint16_t *src = ScaleBuffer[ScaleBuf];
+	uint16_t n = ScaleOut - src, i, k;
+	ScaleCol = 0;
+	ScaleRows--;
+	if (n == 0)
+		return;
+	display_wait();
+	if (n < DMA_MIN_PIXELS)
+	{
+		for (k = 0; k < DISPLAY_SCALE; k++)
+			for (i = 0; i < n; i++)
+				sendWord(src[i]);
+	}
+	else
+	{
+		startDMA(src, n, 1);
+		RepeatSrc = src;
+		RepeatCount = n;
+		RepeatsLeft = DISPLAY_SCALE - 1;
+		ScaleBuf ^= 1;
+		if (ScaleRows == 0)
+			display_wait();  // nothing else may come along to send the last row again
+	}
+	ScaleOut = ScaleBuffer[ScaleBuf];
+}
+#endif
+void sendPixels(const uint16_t *src, uint32_t count)
+{
+	// Long runs held in flash go to the DMA, everything else is fed by the CPU
+#if DISPLAY_SCALE > 1
+	// (scaled pixels are all collected into rows by sendPixel)
+	while (count--)
+		sendPixel(*src++);
+	return;
+#endif
+	if ((count >= DMA_MIN_PIXELS) && ((uint32_t)src < SRAM_BASE))
+	{
+		streamPixels(src, count);
+		return;
+	}
+	display_wait();
+	while (count--)
+		sendPixel(*src++);
+}
+void sendReversed(const uint16_t *src, uint16_t count)
+{
+	// Send src[count-1] down to src[0].  Long rows are reversed into one line buffer
+	// while the DMA sends the other.
+	uint16_t block, x;
+	uint16_t *dst;
+	static int buf = 0;
+#if DISPLAY_SCALE > 1
+	while (count--)
+		sendPixel(src[count]);
+	return;
+#endif
+	if (count < DMA_MIN_PIXELS)
+	{
+		display_wait();
+		while (count--)
+			sendPixel(src[count]);
+		return;
+	}
+	while (count)
+	{
+		block = (count > LINE_BUFFER_SIZE) ? LINE_BUFFER_SIZE : count;
+		dst = LineBuffer[buf];
+		for (x = 0; x < block; x++)
+		{
+			count--;
+			dst[x] = src[count];
+		}
+		display_wait();
+		startDMA(dst, block, 1);
+		buf ^= 1;
+	}
+}
+void sendFill(uint16_t colour, uint32_t count)
+{
+#if DISPLAY_SCALE > 1
+	// Whole rows of the aperture go out as one run of their scaled size, the
+	// pixels before and after them through sendPixel
+	uint32_t Rows;
+	while (count && ScaleCol)
+	{
+		sendPixel(colour);
+		count--;
+	}
+	Rows = count / ScaleWidth;
+	count -= Rows * ScaleWidth;
+	ScaleRows -= Rows;
+	if (Rows && ScaleVisible)
+		sendRun(colour, Rows * ScaleVisible * DISPLAY_SCALE * DISPLAY_SCALE);
+	while (count--)
+		sendPixel(colour);
+#else
+	sendRun(colour, count);
+#endif
+}
+void sendRun(uint16_t colour, uint32_t count)
+{
+	// The DMA repeats a single colour word (no memory increment) for long runs
+	uint16_t block;
+	display_wait();
+	if (count < DMA_MIN_PIXELS)
+	{
+		while (count--)
+			sendWord(colour);
+		return;
+	}
+	FillColour = colour;
+	while (count)
+	{
+		block = (count > 0xffff) ? 0xffff : (uint16_t)count;
+		display_wait();
+		startDMA(&FillColour, block, 0);
+		count -= block;
+	}
+}
+void endPixels(void)
+{
+	// A DMA transfer can be left to finish by itself (display_wait picks it up later),
+	// the CPU path waits for the SPI to go idle just once at the end of the burst.
+	if ((DMA1_Channel3->CCR & (1 << 0)) == 0)
+		finishSPI();
+}
+void display_writePixels(const uint16_t *src, uint32_t n)
+{
+	// Send n pixels into the aperture opened by openAperture
+	DCHigh();
+	sendPixels(src, n);
+	endPixels();
+}
+void display_fillPixels(uint16_t colour, uint32_t n)
+{
+	// Send n pixels of one colour into the aperture opened by openAperture
+	DCHigh();
+	sendFill(colour, n);
+	endPixels();
+}
+void command(uint8_t cmd)
+{
+	display_wait(); // D/C must not change while pixel data is still going out
+	DCLow();
+	transferSPI8(cmd);
+	Stats.CommandBytes++;
+}
+
+void data(uint8_t data)
+{
+	DCHigh();
+	transferSPI8(data);
+	Stats.CommandBytes++;
+}
+
+
+void openAperture(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    // open up an area for drawing on the display    
+	// The controller keeps its window between writes so CASET and RASET are only
+	// sent when they change.  RAMWR is always needed to restart the write pointer.
+	Stats.Apertures++;
+#if DISPLAY_SCALE > 1
+	// The window is in screen coordinates: open the panel area under it, less any
+	// columns off the edge.  sendPixel drops the pixels for those.
+	ScaleWidth = x2 - x1 + 1;
+	ScaleRows = y2 - y1 + 1;
+	ScaleCol = 0;
+	ScaleSkip = (x1 < SCALE_X0) ? SCALE_X0 - x1 : 0;
+	x1 += ScaleSkip;
+	if (x2 >= SCALE_X1)
+		x2 = SCALE_X1 - 1;
+	ScaleVisible = (x2 >= x1) ? x2 - x1 + 1 : 0;
+	ScaleOut = ScaleBuffer[ScaleBuf];
+	if (ScaleVisible == 0)
+		return;
+	x1 = x1 * DISPLAY_SCALE + SCALE_OFFSET;
+	x2 = x2 * DISPLAY_SCALE + SCALE_OFFSET + DISPLAY_SCALE - 1;
+	y1 = y1 * DISPLAY_SCALE;
+	y2 = y2 * DISPLAY_SCALE + DISPLAY_SCALE - 1;
+#endif
+	if ( (x1 != WinX1) || (x2 != WinX2) )
+	{
+		command(0x2A); // Set X limits    	
+		data(x1>>8);
+		data(x1&0xff);        
+		data(x2>>8);
+		data(x2&0xff);
+		WinX1 = x1;
+		WinX2 = x2;
+	}
+	else
+	{
+		Stats.SavedBytes += 5;
+	}
+	if ( (y1 != WinY1) || (y2 != WinY2) )
+	{
+		command(0x2B);// Set Y limits
+		data(y1>>8);
+		data(y1&0xff);        
+		data(y2>>8);
+		data(y2&0xff);    
+		WinY1 = y1;
+		WinY2 = y2;
+	}
+	else
+	{
+		Stats.SavedBytes += 5;
+	}
+        
+    command(0x2c); // put display in to data write mode
+	
+}
+void display_invalidate()
+{
+	// Forget the cached window, e.g. after a reset or a change of MADCTL
+	WinX1 = WINDOW_UNKNOWN;
+	WinY1 = WINDOW_UNKNOWN;
+}
+void display_setScrollArea(uint16_t Top, uint16_t Height)
+{
+	// VSCRDEF: Top fixed rows, then Height rows that scroll, the rest of frame
+	// memory is the bottom fixed area.  Scrolling restarts at the top.
+	uint16_t Fixed = Top * DISPLAY_SCALE, Rows = Height * DISPLAY_SCALE;
+	uint16_t Bottom = FRAME_ROWS - Fixed - Rows;
+	command(0x33);
+	data(Fixed >> 8);
+	data(Fixed & 0xff);
+	data(Rows >> 8);
+	data(Rows & 0xff);
+	data(Bottom >> 8);
+	data(Bottom & 0xff);
+	ScrollLine = WINDOW_UNKNOWN;
+	display_scrollTo(Top);
+}
+void display_scrollTo(uint16_t Line)
+{
+	// VSCRSADD: show frame memory row Line at the top of the scrolling area.
+	// Only the start address changes, nothing is redrawn.
+	if (Line == ScrollLine)
+		return;
+	ScrollLine = Line;
+	Line *= DISPLAY_SCALE;
+	command(0x37);
+	data(Line >> 8);
+	data(Line & 0xff);
+}
+void display_setIdle(int On)
+{
+	// Idle mode shows only 8 colours (the top bit of each channel) and lets the
+	// panel run on less power.  Frame memory keeps the full colours.
+	On = (On != 0);
+	if (On == IdleOn)
+		return;
+	command(On ? 0x39 : 0x38); // IDMON / IDMOFF
+	IdleOn = On;
+}
+void display_setPartial(uint16_t Top, uint16_t Bottom)
+{
+	// Only frame memory rows Top to Bottom are shown and refreshed, the rest of
+	// the panel is blank.  For screens whose content is all in one band.
+	uint16_t First = Top * DISPLAY_SCALE, Last = Bottom * DISPLAY_SCALE + DISPLAY_SCALE - 1;
+	if ((Top != PartialTop) || (Bottom != PartialBottom))
+	{
+		command(0x30); // PTLAR
+		data(First >> 8);
+		data(First & 0xff);
+		data(Last >> 8);
+		data(Last & 0xff);
+		PartialTop = Top;
+		PartialBottom = Bottom;
+	}
+	if (PartialOn == 0)
+	{
+		command(0x12); // PTLON
+		PartialOn = 1;
+	}
+}
+void display_setNormal()
+{
+	// Leave partial mode.  NORON also ends vertical scrolling, so the scroll start
+	// is sent again by the next display_scrollTo.
+	if (PartialOn == 0)
+		return;
+	command(0x13); // NORON
+	PartialOn = 0;
+	ScrollLine = WINDOW_UNKNOWN;
+}
+void display_sleep(uint32_t Now)
+{
+	// Turn the panel off; frame memory is kept.  Nothing is waited for here:
+	// display_wake holds sleep out back until the panel will accept it.
+	if (Asleep)
+		return;
+	command(0x10); // SLPIN
+	Asleep = 1;
+	SleepSince = Now;
+}
+int display_wake(uint32_t Now)
+{
+	// Turn the panel back on, returns 1 once it can be drawn on.  Like display_poll
+	// it is called again as time passes, and each wait is one tick longer than the
+	// datasheet minimum.
+	if (Asleep == 1)
+	{
+		// 120ms after sleep in before sleep out is accepted (which also covers
+		// the 5ms before any other command)
+		if (Now - SleepSince < 121)
+			return 0;
+		command(0x11); // SLPOUT
+		Asleep = 2;
+		SleepSince = Now;
+	}
+	if (Asleep == 2)
+	{
+		// 5ms after sleep out before any other command
+		if (Now - SleepSince < 6)
+			return 0;
+		Asleep = 0;
+	}
+	return 1;
+}
+void display_getStats(DisplayStats *s)
+{
+	*s = Stats;
+}
+void display_resetStats()
+{
+	Stats.CommandBytes = 0;
+	Stats.SavedBytes = 0;
+	Stats.Apertures = 0;
+}
+void display_setClip(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	// Limit drawing to a rectangle, itself trimmed to the screen.  Each drawing call
+	// cuts its area down to it once, before opening its aperture, so shapes and
+	// images may hang off the edges (or start at negative coordinates, taken as signed).
+	int32_t x0 = (int16_t)x, y0 = (int16_t)y;
+	int32_t x1 = x0 + w, y1 = y0 + h;
+	ClipX0 = (x0 < 0) ? 0 : x0;
+	ClipY0 = (y0 < 0) ? 0 : y0;
+	ClipX1 = (x1 > SCREEN_WIDTH) ? SCREEN_WIDTH : x1;
+	ClipY1 = (y1 > SCREEN_HEIGHT) ? SCREEN_HEIGHT : y1;
+}
+void display_resetClip()
+{
+	display_setClip(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+int clipArea(uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h, uint16_t *SkipX, uint16_t *SkipY)
+{
+	// Trim the w x h area at x,y to the clip rectangle.  Returns 0 if none of it is
+	// left, otherwise moves x,y to the first pixel left, shrinks w and h and gives the
+	// number of columns and rows cut off the left and the top.
+	int32_t x0 = (int16_t)*x, y0 = (int16_t)*y;
+	int32_t x1 = x0 + *w, y1 = y0 + *h;
+	*SkipX = (x0 < ClipX0) ? ClipX0 - x0 : 0;
+	*SkipY = (y0 < ClipY0) ? ClipY0 - y0 : 0;
+	x0 += *SkipX;
+	y0 += *SkipY;
+	if (x1 > ClipX1)
+		x1 = ClipX1;
+	if (y1 > ClipY1)
+		y1 = ClipY1;
+	if ((x1 <= x0) || (y1 <= y0))
+		return 0;
+	*x = x0;
+	*y = y0;
+	*w = x1 - x0;
+	*h = y1 - y0;
+	return 1;
+}
+void fillRectangle(uint16_t x,uint16_t y,uint16_t width, uint16_t height, uint16_t colour)
+{
+	uint16_t SkipX, SkipY;
+	if (clipArea(&x, &y, &width, &height, &SkipX, &SkipY) == 0)
+		return;
+	openAperture(x, y, x + width - 1, y + height - 1);
+	display_fillPixels(colour, (uint32_t)width * height);
+}
+void putPixel(uint16_t x, uint16_t y, uint16_t colour)
+{
+	if (((int16_t)x < ClipX0) || ((int16_t)x >= ClipX1) || ((int16_t)y < ClipY0) || ((int16_t)y >= ClipY1))
+		return;
+	openAperture(x, y, x, y);
+	display_fillPixels(colour, 1);
+}
+void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation)
+{
+	// Images held in flash may be left streaming on return; RAM images are finished
+	// before returning as the caller is free to reuse them.  Only the rows and columns
+	// inside the clip rectangle are sent.
+	uint32_t offset = 0;
+	uint16_t w = width, h = height, SkipX, SkipY, row;
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	if ((hOrientation == 0) && (vOrientation == 0) && (w == width))
+	{
+		sendPixels(&Image[(uint32_t)SkipY * width], (uint32_t)w * h);
+	}
+	else
+	{
+		for (row = SkipY; row < SkipY + h; row++)
+		{
+			if (vOrientation == 0)
+				offset=row*width;
+			else
+				offset=(height-(row+1))*width;
+			if (hOrientation == 0)
+				sendPixels(&Image[offset + SkipX], w);
+			else
+				sendReversed(&Image[offset + width - SkipX - w], w);
+		}
+	}
+	endPixels();
+}
+void putImagePal(uint16_t x, uint16_t y, const PalImage *Image, int hOrientation, int vOrientation)
+{
+	// Palette images are expanded to RGB565 a pixel at a time on the way out
+	uint16_t width = Image->Width;
+	uint16_t height = Image->Height;
+	uint16_t stride = (width + 1) / 2;
+	uint16_t w = width, h = height, SkipX, SkipY;
+	uint16_t row, col, sx;
+	const uint16_t *Palette = Image->Palette;
+	const uint8_t *src;
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	display_wait();
+	for (row = SkipY; row < SkipY + h; row++)
+	{
+		if (vOrientation == 0)
+			src = &Image->Pixels[row * stride];
+		else
+			src = &Image->Pixels[(height - (row + 1)) * stride];
+		for (col = SkipX; col < SkipX + w; col++)
+		{
+			if (hOrientation == 0)
+				sx = col;
+			else
+				sx = width - (col + 1);
+			if (sx & 1)
+				sendPixel(Palette[src[sx >> 1] & 0x0f]);
+			else
+				sendPixel(Palette[src[sx >> 1] >> 4]);
+		}
+	}
+	endPixels();
+}
+void putImageRLE(uint16_t x, uint16_t y, const RLEImage *Image)
+{
+	// Runs become fills (the DMA takes the long ones), literals are fed by the CPU.
+	// Packets are cut where they cross a row, and each piece trimmed to the clip
+	// rectangle.  Decoding stops after the last row inside it.
+	const uint8_t *src = Image->Data;
+	uint16_t w = Image->Width, h = Image->Height, SkipX, SkipY;
+	uint16_t row = 0, col = 0, count, colour = 0, n, a, b;
+	uint8_t Run;
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	while (row < SkipY + h)
+	{
+		count = (*src & 0x7f) + 1;
+		Run = *src++ & 0x80;
+		if (Run)
+		{
+			colour = src[0] | (src[1] << 8);
+			src += 2;
+		}
+		while ((count) && (row < SkipY + h))
+		{
+			// the part of the packet on this row, and the part of that inside the clip
+			n = Image->Width - col;
+			if (n > count)
+				n = count;
+			a = (col > SkipX) ? col : SkipX;
+			b = (col + n < SkipX + w) ? col + n : SkipX + w;
+			if ((row >= SkipY) && (a < b))
+			{
+				if (Run)
+				{
+					sendFill(colour, b - a);
+				}
+				else
+				{
+					display_wait();
+					for (; a < b; a++)
+						sendPixel(src[2 * (a - col)] | (src[2 * (a - col) + 1] << 8));
+				}
+			}
+			if (Run == 0)
+				src += 2 * n;
+			count -= n;
+			col += n;
+			if (col == Image->Width)
+			{
+				col = 0;
+				row++;
+			}
+		}
+	}
+	endPixels();
+}
+void drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t Colour)
+{
+	// w pixels to the right of x,y in a single aperture
+	uint16_t h = 1, SkipX, SkipY;
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	openAperture(x, y, x + w - 1, y);
+	display_fillPixels(Colour, w);
+}
+void drawVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t Colour)
+{
+	// h pixels down from x,y in a single aperture
+	uint16_t w = 1, SkipX, SkipY;
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	openAperture(x, y, x, y + h - 1);
+	display_fillPixels(Colour, h);
+}
+void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t Colour)
+{
+	// Reference : https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm    
+	// Coordinates are taken as signed so that a line can start off the screen
+	int X0 = (int16_t)x0, Y0 = (int16_t)y0, X1 = (int16_t)x1, Y1 = (int16_t)y1;
+    if (Y0 == Y1)
+    {
+        if (X0 > X1)
+            drawHLine((uint16_t)X1, (uint16_t)Y0, X0 - X1 + 1, Colour);
+        else
+            drawHLine((uint16_t)X0, (uint16_t)Y0, X1 - X0 + 1, Colour);
+    }
+    else if (X0 == X1)
+    {
+        if (Y0 > Y1)
+            drawVLine((uint16_t)X0, (uint16_t)Y1, Y0 - Y1 + 1, Colour);
+        else
+            drawVLine((uint16_t)X0, (uint16_t)Y0, Y1 - Y0 + 1, Colour);
+    }
+    else if ( iabs(Y1 - Y0) < iabs(X1 - X0) )
+    {
+        if (X0 > X1)
+        {
+            drawLineLowSlope(X1, Y1, X0, Y0, Colour);
+        }
+        else
+        {
+            drawLineLowSlope(X0, Y0, X1, Y1, Colour);
+        }
+    }
+    else
+    {
+        if (Y0 > Y1) 
+        {
+            drawLineHighSlope(X1, Y1, X0, Y0, Colour);
+        }
+        else
+        {
+            drawLineHighSlope(X0, Y0, X1, Y1, Colour);
+        }
+        
+    }    
+}
+int iabs(int x) // simple integer version of abs for use by graphics functions        
+{
+	if (x < 0)
+		x = -x;
+	return x;
+}
+void drawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Colour)
+{
+	drawHLine(x, y, w + 1, Colour);
+	drawVLine(x, y, h + 1, Colour);
+	drawVLine(x + w, y, h + 1, Colour);
+	drawHLine(x, y + h, w + 1, Colour);
+}
+void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour)
+{
+	// Each row of the outline runs from where the row below ends to where this row ends,
+	// so the two mirror images of a row cost one span each rather than one aperture per pixel.
+	// Rows are clipped to the clip rectangle.
+	int R = radius - 1;
+	int dy, outer, inner, next;
+	if (R < 0)
+		return;
+	outer = ellipseHalfWidth(R, R, 0);
+	for (dy = 0; dy <= R; dy++)
+	{
+		next = (dy < R) ? ellipseHalfWidth(R, R, dy + 1) : -1;
+		inner = next + 1;
+		if (inner > outer)
+			inner = outer;
+		if (inner == 0)
+		{
+			fillSpan(x0 - outer, x0 + outer, y0 + dy, Colour);
+			if (dy != 0)
+				fillSpan(x0 - outer, x0 + outer, y0 - dy, Colour);
+		}
+		else
+		{
+			fillSpan(x0 - outer, x0 - inner, y0 + dy, Colour);
+			fillSpan(x0 + inner, x0 + outer, y0 + dy, Colour);
+			if (dy != 0)
+			{
+				fillSpan(x0 - outer, x0 - inner, y0 - dy, Colour);
+				fillSpan(x0 + inner, x0 + outer, y0 - dy, Colour);
+			}
+		}
+		outer = next;
+	}
+}
+void fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour)
+{
+	// Same footprint as before (the outline sits radius-1 pixels from the centre)
+	if (radius == 0)
+		return;
+	fillEllipse(x0, y0, radius - 1, radius - 1, Colour);
+}
+void fillEllipse(uint16_t x0, uint16_t y0, uint16_t rx, uint16_t ry, uint16_t Colour)
+{
+	// One span per row, worked outwards from the centre line.  Rows are clipped
+	// to the clip rectangle so the ellipse may hang off any side.
+	int dy, half;
+	for (dy = 0; dy <= ry; dy++)
+	{
+		half = ellipseHalfWidth(rx, ry, dy);
+		fillSpan(x0 - half, x0 + half, y0 + dy, Colour);
+		if (dy != 0)
+			fillSpan(x0 - half, x0 + half, y0 - dy, Colour);
+	}
+}
+int ellipseHalfWidth(int rx, int ry, int dy)
+{
+	// Largest x for which x,dy is inside the ellipse: x*x*ry*ry + dy*dy*rx*rx <= rx*rx*ry*ry
+	// with an extra rx*ry*(rx+ry)/2 so the edge is rounded to the nearest pixel rather than
+	// cut inside it.  Good for radii up to about 200 before the sums overflow.
+	int32_t rx2 = rx * rx;
+	int32_t ry2 = ry * ry;
+	int32_t limit = rx2 * ry2 + ((rx * ry * (rx + ry)) >> 1) - dy * dy * rx2;
+	int x = rx;
+	while ((x > 0) && (x * x * ry2 > limit))
+		x--;
+	return x;
+}
+void fillSpan(int x0, int x1, int y, uint16_t Colour)
+{
+	// Horizontal run from x0 to x1 inclusive, clipped by drawHLine
+	if (x1 < x0)
+		return;
+	drawHLine((uint16_t)x0, (uint16_t)y, (uint16_t)(x1 - x0 + 1), Colour);
+}
+void printText(const char *Text,uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	printTextScaled(Text, x, y, 1, ForeColour, BackColour);
+}
+void printTextX2(const char *Text, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	printTextScaled(Text, x, y, 2, ForeColour, BackColour);
+}
+void printTextScaled(const char *Text, uint16_t x, uint16_t y, uint16_t Scale, uint16_t ForeColour, uint16_t BackColour)
+{
+	// The whole string goes out through a single aperture, one scanline at a time.  Each
+	// font row is sent Scale times, its bits turned into runs of one colour on the way
+	// out, so no image of the characters is built in RAM.  Characters are 2 pixels apart
+	// (the gap is written in the background colour).  Scanlines and columns outside the
+	// clip rectangle are left out of the runs.  Scale is 1 to 4.
+	uint16_t Width, w, h, SkipX, SkipY, End, Line, Col, Run, Repeat, n, Visible;
+	uint8_t Row, Bits, Bit, On, RunOn;
+	const char *Next;
+	if ((Scale < 1) || (Scale > 4))
+		return;
+	Width = countGlyphs(Text) * (FONT_WIDTH * Scale + 2);
+	if (Width == 0)
+		return;
+	w = Width - 2; // no gap after the last character
+	h = FONT_HEIGHT * Scale;
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	End = SkipX + w;
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	Line = 0;
+	for (Row = 0; Row < FONT_HEIGHT; Row++)
+	{
+		for (Repeat = 0; Repeat < Scale; Repeat++, Line++)
+		{
+			if ((Line < SkipY) || (Line >= SkipY + h))
+				continue;
+			Next = Text;
+			Col = 0;
+			Run = 0;
+			RunOn = 0;
+			while (Col < End)
+			{
+				Bits = Font5x7Rows[nextGlyph(&Next) * FONT_HEIGHT + Row];
+				// FONT_WIDTH dots Scale pixels wide, then the two gap pixels
+				for (Bit = 0; (Bit < FONT_WIDTH + 2) && (Col < End); Bit++)
+				{
+					if (Bit < FONT_WIDTH)
+					{
+						On = Bits & 1;
+						Bits >>= 1;
+						n = Scale;
+					}
+					else
+					{
+						On = 0;
+						n = 1;
+					}
+					if (n > End - Col)
+						n = End - Col;
+					// the part right of SkipX goes into the run
+					Visible = (Col + n <= SkipX) ? 0 : (Col >= SkipX) ? n : Col + n - SkipX;
+					Col += n;
+					if (Visible == 0)
+						continue;
+					if ((On != RunOn) && (Run != 0))
+					{
+						sendFill(RunOn ? ForeColour : BackColour, Run);
+						Run = 0;
+					}
+					RunOn = On;
+					Run += Visible;
+				}
+			}
+			sendFill(RunOn ? ForeColour : BackColour, Run);
+		}
+	}
+	endPixels();
+}
+void printNumber(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	printNumberScaled(Number, x, y, 1, ForeColour, BackColour);
+}
+void printNumberX2(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	printNumberScaled(Number, x, y, 2, ForeColour, BackColour);
+}
+void printNumberScaled(uint16_t Number, uint16_t x, uint16_t y, uint16_t Scale, uint16_t ForeColour, uint16_t BackColour)
+{
+	// This function converts the supplied number into a five digit string and then calls on
+	// printTextScaled to write it to the display
+	char Buffer[6]; // Maximum value = 65535
+	uint8_t i;
+	Buffer[5] = 0;
+	for (i = 5; i > 0; i--)
+	{
+		Buffer[i - 1] = Number % 10 + '0';
+		Number = Number / 10;
+	}
+	printTextScaled(Buffer, x, y, Scale, ForeColour, BackColour);
+}
+void makeGradient(uint16_t *Ramp, uint16_t Steps, uint16_t R0, uint16_t G0, uint16_t B0, uint16_t R1, uint16_t G1, uint16_t B1)
+{
+	// Ramp[i] is the colour i/Steps of the way from R0,G0,B0 towards R1,G1,B1 (the end
+	// colour itself is not reached, so the ramp can be repeated by fillPattern without a seam).
+	// Channels are stepped in 16.16 fixed point; the only divisions are the three here.
+	int32_t r = (int32_t)R0 << 16, g = (int32_t)G0 << 16, b = (int32_t)B0 << 16;
+	int32_t dr, dg, db;
+	uint16_t i;
+	if (Steps == 0)
+		return;
+	dr = (((int32_t)R1 - R0) << 16) / Steps;
+	dg = (((int32_t)G1 - G0) << 16) / Steps;
+	db = (((int32_t)B1 - B0) << 16) / Steps;
+	for (i = 0; i < Steps; i++)
+	{
+		Ramp[i] = RGBToWord(r >> 16, g >> 16, b >> 16);
+		r += dr;
+		g += dg;
+		b += db;
+	}
+}
+void fillGradientV(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t R0, uint16_t G0, uint16_t B0, uint16_t R1, uint16_t G1, uint16_t B1)
+{
+	// Top row R0,G0,B0 to bottom row R1,G1,B1 through a single aperture.  Each row is one fill.
+	// When the area is clipped the ramp starts part way in, so the gradient stays in place.
+	int32_t r = (int32_t)R0 << 16, g = (int32_t)G0 << 16, b = (int32_t)B0 << 16;
+	int32_t dr = 0, dg = 0, db = 0;
+	uint16_t Height = h, row, SkipX, SkipY;
+	if (h > 1)
+	{
+		dr = (((int32_t)R1 - R0) << 16) / (h - 1);
+		dg = (((int32_t)G1 - G0) << 16) / (h - 1);
+		db = (((int32_t)B1 - B0) << 16) / (h - 1);
+	}
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	r += dr * SkipY;
+	g += dg * SkipY;
+	b += db * SkipY;
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	for (row = 0; row < h; row++)
+	{
+		if (SkipY + row == Height - 1)
+			sendFill(RGBToWord(R1, G1, B1), w);	// the bottom row is exactly the end colour
+		else
+			sendFill(RGBToWord(r >> 16, g >> 16, b >> 16), w);
+		r += dr;
+		g += dg;
+		b += db;
+	}
+	endPixels();
+}
+void fillGradientH(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t R0, uint16_t G0, uint16_t B0, uint16_t R1, uint16_t G1, uint16_t B1)
+{
+	// Left column R0,G0,B0 to right column R1,G1,B1 through a single aperture.  The visible
+	// part of one row of colours is worked out up front and then sent h times; it starts
+	// part way along the ramp when the area is clipped, so the gradient stays in place.
+	uint16_t Ramp[SCREEN_WIDTH];
+	int32_t r = (int32_t)R0 << 16, g = (int32_t)G0 << 16, b = (int32_t)B0 << 16;
+	int32_t dr = 0, dg = 0, db = 0;
+	uint16_t Width = w, col, SkipX, SkipY;
+	if (w > 1)
+	{
+		dr = (((int32_t)R1 - R0) << 16) / (w - 1);
+		dg = (((int32_t)G1 - G0) << 16) / (w - 1);
+		db = (((int32_t)B1 - B0) << 16) / (w - 1);
+	}
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	r += dr * SkipX;
+	g += dg * SkipX;
+	b += db * SkipX;
+	for (col = 0; col < w; col++)	// the clip rectangle is on the screen, so w <= SCREEN_WIDTH
+	{
+		Ramp[col] = RGBToWord(r >> 16, g >> 16, b >> 16);
+		r += dr;
+		g += dg;
+		b += db;
+	}
+	if (SkipX + w == Width)
+		Ramp[w - 1] = RGBToWord(R1, G1, B1);	// the right column is exactly the end colour
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	while (h--)
+		sendPixels(Ramp, w);
+	endPixels();
+}
+void fillPattern(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *Pattern, uint16_t pw, uint16_t ph)
+{
+	// Tile a pw x ph pattern over the area, starting with its top left corner at x,y,
+	// through a single aperture.  A pattern one pixel wide is sent as one fill per row.
+	// When the area is clipped the pattern starts part way in, so it stays in place.
+	uint16_t row, col, prow, pcol, pcol0, SkipX, SkipY;
+	const uint16_t *src;
+	if ((pw == 0) || (ph == 0) || (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0))
+		return;
+	prow = SkipY % ph;
+	pcol0 = SkipX % pw;
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	for (row = 0; row < h; row++)
+	{
+		src = &Pattern[prow * pw];
+		if (pw == 1)
+		{
+			sendFill(*src, w);
+		}
+		else
+		{
+			display_wait();
+			pcol = pcol0;
+			for (col = 0; col < w; col++)
+			{
+				sendPixel(src[pcol]);
+				if (++pcol == pw)
+					pcol = 0;
+			}
+		}
+		if (++prow == ph)
+			prow = 0;
+	}
+	endPixels();
+}
+void composeArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Layer *Layers, uint16_t Count)
+{
+	// Draw a stack of layers (the first at the bottom, black under them all) in bands
+	// of BAND_ROWS rows.  Each band is built in RAM and goes out in one DMA burst while
+	// the next one is built, all through a single aperture, so every pixel of the area
+	// is sent exactly once.  The area is trimmed to the clip rectangle.
+	uint16_t row, r, n, i, SkipX, SkipY, Band = 0;
+	uint16_t *Row;
+	if (clipArea(&x, &y, &w, &h, &SkipX, &SkipY) == 0)
+		return;
+	openAperture(x, y, x + w - 1, y + h - 1);
+	DCHigh();
+	for (row = 0; row < h; row += n)
+	{
+		// the DMA can only be busy with the other band here
+		n = (h - row > BAND_ROWS) ? BAND_ROWS : h - row;
+		for (r = 0; r < n; r++)
+		{
+			Row = &BandBuffer[Band][r * w];
+			for (i = 0; i < w; i++)
+				Row[i] = 0;
+			for (i = 0; i < Count; i++)
+				composeLayer(&Layers[i], Row, x, w, y + row + r);
+		}
+#if DISPLAY_SCALE > 1
+		sendPixels(BandBuffer[Band], n * w);
+#else
+		display_wait();
+		startDMA(BandBuffer[Band], n * w, 1);
+		Band ^= 1;
+#endif
+	}
+}
+void composeLayer(const Layer *L, uint16_t *Row, uint16_t x, uint16_t w, uint16_t y)
+{
+	// Paint the part of one layer on screen row y into a band row covering columns
+	// x to x+w-1
+	uint16_t ly, Col, Scale;
+	uint8_t Bits, Bit, Index;
+	const PalImage *Image;
+	const uint8_t *PalRow;
+	const char *Next;
+	if (y < L->y)
+		return;
+	ly = y - L->y;
+	switch (L->Type)
+	{
+		case LAYER_FILL:
+			if (ly < L->h)
+				composeSpan(Row, x, w, L->x, L->w, L->Colour);
+			break;
+		case LAYER_FRAME:
+			if (ly >= L->h)
+				break;
+			if ((ly == 0) || (ly == L->h - 1))
+			{
+				composeSpan(Row, x, w, L->x, L->w, L->Colour);
+			}
+			else
+			{
+				composeSpan(Row, x, w, L->x, 1, L->Colour);
+				composeSpan(Row, x, w, L->x + L->w - 1, 1, L->Colour);
+			}
+			break;
+		case LAYER_PATTERN:
+			if ((ly < L->h) && (L->Param != 0))
+				composeSpan(Row, x, w, L->x, L->w, ((const uint16_t *)L->Data)[ly % L->Param]);
+			break;
+		case LAYER_IMAGE:
+			// palette index 0 is transparent
+			Image = (const PalImage *)L->Data;
+			if (ly >= Image->Height)
+				break;
+			PalRow = &Image->Pixels[ly * ((Image->Width + 1) / 2)];
+			for (Col = 0; Col < Image->Width; Col++)
+			{
+				if (Col & 1)
+					Index = PalRow[Col >> 1] & 0x0f;
+				else
+					Index = PalRow[Col >> 1] >> 4;
+				if (Index != 0)
+					composeSpan(Row, x, w, L->x + Col, 1, Image->Palette[Index]);
+			}
+			break;
+		case LAYER_TEXT:
+			// spaced as printTextScaled spaces them, with no background
+			Scale = L->Param;
+			if ((Scale == 0) || (ly >= FONT_HEIGHT * Scale))
+				break;
+			Next = (const char *)L->Data;
+			Col = L->x;
+			while ((*Next) && (Col < x + w))
+			{
+				Bits = Font5x7Rows[nextGlyph(&Next) * FONT_HEIGHT + ly / Scale];
+				for (Bit = 0; Bits != 0; Bit++, Bits >>= 1)
+				{
+					if (Bits & 1)
+						composeSpan(Row, x, w, Col + Bit * Scale, Scale, L->Colour);
+				}
+				Col += FONT_WIDTH * Scale + 2;
+			}
+			break;
+	}
+}
+void composeSpan(uint16_t *Row, uint16_t x, uint16_t w, uint16_t From, uint16_t n, uint16_t Colour)
+{
+	// Fill screen columns From to From+n-1, as far as they fall in the band row
+	uint16_t To = From + n;
+	if (From < x)
+		From = x;
+	if (To > x + w)
+		To = x + w;
+	while (From < To)
+		Row[From++ - x] = Colour;
+}
+uint16_t RGBToWord(uint16_t R, uint16_t G, uint16_t B)
+{
+	uint16_t rvalue = 0;
+    rvalue += G >> 5;
+    rvalue += (G & (7)) << 13;
+    rvalue += (R >> 3) << 8;
+    rvalue += (B >> 3) << 3;
+    return rvalue;
+}
+void drawLineLowSlope(int x0, int y0, int x1, int y1, uint16_t Colour)
+{
+   // Reference : https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm    
+  int dx = x1 - x0;
+  int dy = y1 - y0;
+  int yi = 1;
+  if (dy < 0)
+  {
+    yi = -1;
+    dy = -dy;
+  }
+  int D = 2*dy - dx;
+  
+  int y = y0;
+  int run = x0; // start of the current run of pixels on row y
+
+  for (int x=x0; x <= x1;x++)
+  {
+    if (D > 0)
+    {
+       drawHLine((uint16_t)run, (uint16_t)y, (uint16_t)(x - run + 1), Colour);
+       run = x + 1;
+       y = y + yi;
+       D = D - 2*dx;
+    }
+    D = D + 2*dy;
+    
+  }
+  drawHLine((uint16_t)run, (uint16_t)y, (uint16_t)(x1 - run + 1), Colour);
+}
+void drawLineHighSlope(int x0, int y0, int x1, int y1, uint16_t Colour)
+{
+  // Reference : https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
+  int dx = x1 - x0;
+  int dy = y1 - y0;
+  int xi = 1;
+  if (dx < 0)
+  {
+    xi = -1;
+    dx = -dx;
+  }  
+  int D = 2*dx - dy;
+  int x = x0;
+  int run = y0; // start of the current run of pixels in column x
+
+  for (int y=y0; y <= y1; y++)
+  {
+    if (D > 0)
+    {
+       drawVLine((uint16_t)x, (uint16_t)run, (uint16_t)(y - run + 1), Colour);
+       run = y + 1;
+       x = x + xi;
+       D = D - 2*dy;
+    }
+    D = D + 2*dx;
+  }
+  drawVLine((uint16_t)x, (uint16_t)run, (uint16_t)(y1 - run + 1), Colour);
+}
+void clear()
+{
+	fillRectangle(0,0,SCREEN_WIDTH, SCREEN_HEIGHT, 0x0000);  // black out the screen
+}
+uint8_t nextGlyph(const char **Text)
+{
+	// Returns the font table index of the next character and steps past it.  Anything
+	// the font does not cover draws as '?'.  UTF-8 sequences count as one character;
+	// the arrows U+2190 to U+2193 map onto the font's own arrow glyphs.
+	const uint8_t *s = (const uint8_t *)*Text;
+	uint8_t c = *s++;
+	uint8_t Glyph = '?' - FONT_FIRST_CHAR;
+	if ((c >= FONT_FIRST_CHAR) && (c < FONT_FIRST_CHAR + FONT_GLYPHS))
+	{
+		Glyph = c - FONT_FIRST_CHAR;
+	}
+	else if (c >= 0xc0)
+	{
+		if ((c == 0xe2) && (s[0] == 0x86) && (s[1] >= 0x90) && (s[1] <= 0x93))
+		{
+			switch (s[1])
+			{
+				case 0x90: Glyph = 127 - FONT_FIRST_CHAR; break;	// left arrow
+				case 0x91: Glyph = '^' - FONT_FIRST_CHAR; break;	// up arrow
+				case 0x92: Glyph = 126 - FONT_FIRST_CHAR; break;	// right arrow
+				case 0x93: Glyph = 'v' - FONT_FIRST_CHAR; break;	// down arrow
+			}
+		}
+		while ((*s & 0xc0) == 0x80)	// skip the continuation bytes
+			s++;
+	}
+	*Text = (const char *)s;
+	return Glyph;
+}
+uint16_t countGlyphs(const char *Text)
+{
+	uint16_t Count = 0;
+	while (*Text)
+	{
+		nextGlyph(&Text);
+		Count++;
+	}
+	return Count;
+}
+
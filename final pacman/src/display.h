@@ -1,14 +1,111 @@
-void display_begin(void);
-void delay(uint32_t dly);
-void fillRectangle(uint16_t x,uint16_t y,uint16_t width, uint16_t height, uint16_t colour);
-void putPixel(uint16_t x, uint16_t y, uint16_t colour);
-void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation,int vOrientation);
-void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t Colour);
-void drawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Colour);
-void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour);
-void fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour);
-void printText(const char *Text,uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
-void printTextX2(const char *Text, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
-void printNumber(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
-void printNumberX2(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
-uint16_t RGBToWord(uint16_t R, uint16_t G, uint16_t B);
\ No newline at end of file
+// Panel, chosen at build time: the 128x160 ST7735 by default, or a 240x320 ILI9341
+// with -DDISPLAY_ILI9341.  On the ILI9341 -DDISPLAY_SCALE=2 draws every pixel as a
+// 2x2 block so that the 128x160 screen fills the panel; the 4 columns at each side
+// that do not fit are cut off.
+#ifdef DISPLAY_ILI9341
+#define PANEL_WIDTH 240
+#define PANEL_HEIGHT 320
+#else
+#define PANEL_WIDTH 128
+#define PANEL_HEIGHT 160
+#endif
+#ifndef DISPLAY_SCALE
+#define DISPLAY_SCALE 1
+#endif
+// Size of the screen in drawing coordinates
+#if DISPLAY_SCALE == 1
+#define SCREEN_WIDTH PANEL_WIDTH
+#define SCREEN_HEIGHT PANEL_HEIGHT
+#elif (DISPLAY_SCALE == 2) && defined(DISPLAY_ILI9341)
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 160
+#else
+#error "DISPLAY_SCALE=2 needs DISPLAY_ILI9341"
+#endif
+typedef struct {
+	uint32_t CommandBytes;  // command and parameter bytes sent
+	uint32_t SavedBytes;    // CASET/RASET bytes skipped because the window had not changed
+	uint32_t Apertures;     // calls to openAperture
+} DisplayStats;
+// 4 bit palette image: two pixels per byte, left pixel in the high nibble,
+// each row starting on a new byte.  The palette holds RGBToWord colours.
+typedef struct {
+	uint16_t Width;
+	uint16_t Height;
+	const uint16_t *Palette;
+	const uint8_t *Pixels;
+} PalImage;
+// Run length encoded image, decoded in row order.  Each packet starts with a byte n:
+//   n < 0x80  : n+1 literal pixels follow, 2 bytes each
+//   n >= 0x80 : (n & 0x7f)+1 pixels of the one colour that follows (2 bytes)
+// Colours are RGBToWord values stored low byte first.  Runs may cross rows.
+typedef struct {
+	uint16_t Width;
+	uint16_t Height;
+	const uint8_t *Data;
+} RLEImage;
+// One layer of an area drawn by composeArea.  Layers are drawn in order, each one
+// over the ones before it; x,y is the top left corner in screen coordinates.
+#define LAYER_FILL 0     // w x h rectangle of Colour
+#define LAYER_FRAME 1    // one pixel wide outline of a w x h rectangle
+#define LAYER_PATTERN 2  // w x h rectangle, row r coloured Data[r % Param] (Data is a uint16_t table)
+#define LAYER_IMAGE 3    // PalImage at Data, palette index 0 transparent
+#define LAYER_TEXT 4     // string at Data, Param times normal size, no background
+typedef struct {
+	uint8_t Type;
+	uint8_t Param;
+	uint16_t x;
+	uint16_t y;
+	uint16_t w;
+	uint16_t h;
+	uint16_t Colour;
+	const void *Data;
+} Layer;
+void display_begin(void);
+void display_start(uint32_t Now);
+int display_poll(uint32_t Now);
+int display_ready(void);
+void display_invalidate(void);
+void display_setScrollArea(uint16_t Top, uint16_t Height);
+void display_scrollTo(uint16_t Line);
+void display_setIdle(int On);
+void display_setPartial(uint16_t Top, uint16_t Bottom);
+void display_setNormal(void);
+void display_sleep(uint32_t Now);
+int display_wake(uint32_t Now);
+void display_setClip(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void display_resetClip(void);
+void display_getStats(DisplayStats *s);
+void display_resetStats(void);
+void display_wait(void);
+int display_busy(void);
+void display_writePixels(const uint16_t *src, uint32_t n);
+void display_fillPixels(uint16_t colour, uint32_t n);
+void openAperture(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+void delay(uint32_t dly);
+void fillRectangle(uint16_t x,uint16_t y,uint16_t width, uint16_t height, uint16_t colour);
+void putPixel(uint16_t x, uint16_t y, uint16_t colour);
+void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation,int vOrientation);
+void putImagePal(uint16_t x, uint16_t y, const PalImage *Image, int hOrientation, int vOrientation);
+void putImageRLE(uint16_t x, uint16_t y, const RLEImage *Image);
+void drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t Colour);
+void drawVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t Colour);
+void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t Colour);
+void drawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Colour);
+void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour);
+void fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour);
+void fillEllipse(uint16_t x0, uint16_t y0, uint16_t rx, uint16_t ry, uint16_t Colour);
+void composeArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const Layer *Layers, uint16_t Count);
+void makeGradient(uint16_t *Ramp, uint16_t Steps, uint16_t R0, uint16_t G0, uint16_t B0, uint16_t R1, uint16_t G1, uint16_t B1);
+void fillGradientV(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t R0, uint16_t G0, uint16_t B0, uint16_t R1, uint16_t G1, uint16_t B1);
+void fillGradientH(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t R0, uint16_t G0, uint16_t B0, uint16_t R1, uint16_t G1, uint16_t B1);
+void fillPattern(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *Pattern, uint16_t pw, uint16_t ph);
+void printText(const char *Text,uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
+void printTextX2(const char *Text, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
+void printTextScaled(const char *Text, uint16_t x, uint16_t y, uint16_t Scale, uint16_t ForeColour, uint16_t BackColour);
+void printNumber(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
+void printNumberX2(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour);
+void printNumberScaled(uint16_t Number, uint16_t x, uint16_t y, uint16_t Scale, uint16_t ForeColour, uint16_t BackColour);
+uint16_t RGBToWord(uint16_t R, uint16_t G, uint16_t B);
+// RGBToWord for constant colours, worked out by the compiler
+#define RGB565(R, G, B) ((uint16_t)((((G) >> 5) & 7) | (((G) & 7) << 13) | ((((R) >> 3) & 0x1f) << 8) | ((((B) >> 3) & 0x1f) << 3)))
\ No newline at end of file
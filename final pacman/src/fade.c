@@ -0,0 +1,124 @@
+#include <stdint.h>
+#include "fade.h"
+
+// FadeTable[l][v] is v * l / FADE_LEVELS for a 6 bit channel value v.  5 bit channels
+// are looked up at twice their value and halved, which gives the same result.
+static const uint8_t FadeTable[FADE_LEVELS][64] = {
+	{ // 0/16
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+	},
+	{ // 1/16
+		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+		2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,
+		3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3
+	},
+	{ // 2/16
+		0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,
+		2,2,2,2,2,2,2,2,3,3,3,3,3,3,3,3,
+		4,4,4,4,4,4,4,4,5,5,5,5,5,5,5,5,
+		6,6,6,6,6,6,6,6,7,7,7,7,7,7,7,7
+	},
+	{ // 3/16
+		0,0,0,0,0,0,1,1,1,1,1,2,2,2,2,2,
+		3,3,3,3,3,3,4,4,4,4,4,5,5,5,5,5,
+		6,6,6,6,6,6,7,7,7,7,7,8,8,8,8,8,
+		9,9,9,9,9,9,10,10,10,10,10,11,11,11,11,11
+	},
+	{ // 4/16
+		0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,
+		4,4,4,4,5,5,5,5,6,6,6,6,7,7,7,7,
+		8,8,8,8,9,9,9,9,10,10,10,10,11,11,11,11,
+		12,12,12,12,13,13,13,13,14,14,14,14,15,15,15,15
+	},
+	{ // 5/16
+		0,0,0,0,1,1,1,2,2,2,3,3,3,4,4,4,
+		5,5,5,5,6,6,6,7,7,7,8,8,8,9,9,9,
+		10,10,10,10,11,11,11,12,12,12,13,13,13,14,14,14,
+		15,15,15,15,16,16,16,17,17,17,18,18,18,19,19,19
+	},
+	{ // 6/16
+		0,0,0,1,1,1,2,2,3,3,3,4,4,4,5,5,
+		6,6,6,7,7,7,8,8,9,9,9,10,10,10,11,11,
+		12,12,12,13,13,13,14,14,15,15,15,16,16,16,17,17,
+		18,18,18,19,19,19,20,20,21,21,21,22,22,22,23,23
+	},
+	{ // 7/16
+		0,0,0,1,1,2,2,3,3,3,4,4,5,5,6,6,
+		7,7,7,8,8,9,9,10,10,10,11,11,12,12,13,13,
+		14,14,14,15,15,16,16,17,17,17,18,18,19,19,20,20,
+		21,21,21,22,22,23,23,24,24,24,25,25,26,26,27,27
+	},
+	{ // 8/16
+		0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,
+		8,8,9,9,10,10,11,11,12,12,13,13,14,14,15,15,
+		16,16,17,17,18,18,19,19,20,20,21,21,22,22,23,23,
+		24,24,25,25,26,26,27,27,28,28,29,29,30,30,31,31
+	},
+	{ // 9/16
+		0,0,1,1,2,2,3,3,4,5,5,6,6,7,7,8,
+		9,9,10,10,11,11,12,12,13,14,14,15,15,16,16,17,
+		18,18,19,19,20,20,21,21,22,23,23,24,24,25,25,26,
+		27,27,28,28,29,29,30,30,31,32,32,33,33,34,34,35
+	},
+	{ // 10/16
+		0,0,1,1,2,3,3,4,5,5,6,6,7,8,8,9,
+		10,10,11,11,12,13,13,14,15,15,16,16,17,18,18,19,
+		20,20,21,21,22,23,23,24,25,25,26,26,27,28,28,29,
+		30,30,31,31,32,33,33,34,35,35,36,36,37,38,38,39
+	},
+	{ // 11/16
+		0,0,1,2,2,3,4,4,5,6,6,7,8,8,9,10,
+		11,11,12,13,13,14,15,15,16,17,17,18,19,19,20,21,
+		22,22,23,24,24,25,26,26,27,28,28,29,30,30,31,32,
+		33,33,34,35,35,36,37,37,38,39,39,40,41,41,42,43
+	},
+	{ // 12/16
+		0,0,1,2,3,3,4,5,6,6,7,8,9,9,10,11,
+		12,12,13,14,15,15,16,17,18,18,19,20,21,21,22,23,
+		24,24,25,26,27,27,28,29,30,30,31,32,33,33,34,35,
+		36,36,37,38,39,39,40,41,42,42,43,44,45,45,46,47
+	},
+	{ // 13/16
+		0,0,1,2,3,4,4,5,6,7,8,8,9,10,11,12,
+		13,13,14,15,16,17,17,18,19,20,21,21,22,23,24,25,
+		26,26,27,28,29,30,30,31,32,33,34,34,35,36,37,38,
+		39,39,40,41,42,43,43,44,45,46,47,47,48,49,50,51
+	},
+	{ // 14/16
+		0,0,1,2,3,4,5,6,7,7,8,9,10,11,12,13,
+		14,14,15,16,17,18,19,20,21,21,22,23,24,25,26,27,
+		28,28,29,30,31,32,33,34,35,35,36,37,38,39,40,41,
+		42,42,43,44,45,46,47,48,49,49,50,51,52,53,54,55
+	},
+	{ // 15/16
+		0,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,
+		15,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,
+		30,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,
+		45,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59
+	}
+};
+
+uint16_t fade_colour(uint16_t Colour, uint8_t Level)
+{
+	// Colour is in RGBToWord's byte swapped format:
+	// green bits 2-0 in 15-13, red in 12-8, blue in 7-3, green bits 5-3 in 2-0
+	uint16_t r, g, b;
+	const uint8_t *Table;
+	if (Level >= FADE_LEVELS)
+		return Colour;
+	Table = FadeTable[Level];
+	r = Table[((Colour >> 8) & 0x1f) << 1] >> 1;
+	g = Table[((Colour & 7) << 3) | (Colour >> 13)];
+	b = Table[((Colour >> 3) & 0x1f) << 1] >> 1;
+	return (uint16_t)((g >> 3) | ((g & 7) << 13) | (r << 8) | (b << 3));
+}
+void fade_palette(const uint16_t *Src, uint16_t *Dst, uint16_t Count, uint8_t Level)
+{
+	// Dst may be the same as Src
+	while (Count--)
+		*Dst++ = fade_colour(*Src++, Level);
+}
@@ -0,0 +1,7 @@
+#include <stdint.h>
+// Colour fades using a brightness table instead of multiplying each channel.
+// Level 0 is black and FADE_LEVELS is the colour unchanged.
+#define FADE_LEVELS 16
+
+uint16_t fade_colour(uint16_t Colour, uint8_t Level);
+void fade_palette(const uint16_t *Src, uint16_t *Dst, uint16_t Count, uint8_t Level);
@@ -0,0 +1,74 @@
+#include <stdint.h>
+#include "display.h"
+#include "hud.h"
+#define GLYPH_WIDTH 5   // FONT_WIDTH; font5x7.h holds the font itself so only display.c includes it
+
+static const uint16_t Powers[HUD_MAX_DIGITS] = {10000, 1000, 100, 10, 1};
+
+void hud_init(HudNumber *Field, uint16_t x, uint16_t y, uint8_t Digits, uint8_t Scale, uint8_t Flags, uint16_t ForeColour, uint16_t BackColour)
+{
+	Field->x = x;
+	Field->y = y;
+	Field->Digits = (Digits > HUD_MAX_DIGITS) ? HUD_MAX_DIGITS : Digits;
+	Field->Scale = Scale;
+	Field->Flags = Flags;
+	Field->ForeColour = ForeColour;
+	Field->BackColour = BackColour;
+	hud_invalidate(Field);
+}
+void hud_invalidate(HudNumber *Field)
+{
+	// Forget what is on the screen, e.g. after it has been cleared; the next
+	// hud_setNumber draws the whole field
+	uint8_t i;
+	for (i = 0; i < HUD_MAX_DIGITS; i++)
+		Field->Shown[i] = 0;
+}
+void hud_setNumber(HudNumber *Field, uint16_t Value)
+{
+	// Show Value, keeping only its last Digits digits if it is too wide.  The digits
+	// are found by repeated subtraction as the Cortex-M0 has no divide instruction.
+	// Each run of changed characters is drawn with one call to printTextScaled.
+	char Text[HUD_MAX_DIGITS + 1];
+	char Digit;
+	uint8_t i, First, Run, Leading;
+	First = HUD_MAX_DIGITS - Field->Digits;
+	Leading = ((Field->Flags & HUD_LEADING_ZEROS) == 0);
+	for (i = 0; i < HUD_MAX_DIGITS; i++)
+	{
+		Digit = '0';
+		while (Value >= Powers[i])
+		{
+			Value -= Powers[i];
+			Digit++;
+		}
+		if (i < First)
+			continue;
+		if ((Digit != '0') || (i == HUD_MAX_DIGITS - 1))
+			Leading = 0;
+		Text[i - First] = Leading ? ' ' : Digit;
+	}
+	Text[Field->Digits] = 0;
+	i = 0;
+	while (i < Field->Digits)
+	{
+		if (Text[i] == Field->Shown[i])
+		{
+			i++;
+			continue;
+		}
+		Run = 0;
+		while ((i + Run < Field->Digits) && (Text[i + Run] != Field->Shown[i + Run]))
+		{
+			Field->Shown[i + Run] = Text[i + Run];
+			Run++;
+		}
+		// printTextScaled draws up to the terminator; the gaps inside the run are
+		// background, the gaps either side of it are never drawn over
+		Digit = Text[i + Run];
+		Text[i + Run] = 0;
+		printTextScaled(&Text[i], Field->x + i * (GLYPH_WIDTH * Field->Scale + 2), Field->y, Field->Scale, Field->ForeColour, Field->BackColour);
+		Text[i + Run] = Digit;
+		i += Run;
+	}
+}
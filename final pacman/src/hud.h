@@ -0,0 +1,20 @@
+#include <stdint.h>
+// Numeric fields for the heads up display.  Each field remembers the characters it
+// has on the screen and only redraws the ones that change.
+#define HUD_MAX_DIGITS 5
+#define HUD_LEADING_ZEROS 1   // show 007 rather than   7
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+	uint8_t Digits;       // field width in characters, the number is right aligned
+	uint8_t Scale;        // text scale, 1 to 4
+	uint8_t Flags;
+	uint16_t ForeColour;
+	uint16_t BackColour;
+	char Shown[HUD_MAX_DIGITS];   // characters on the screen, 0 if not known
+} HudNumber;
+
+void hud_init(HudNumber *Field, uint16_t x, uint16_t y, uint8_t Digits, uint8_t Scale, uint8_t Flags, uint16_t ForeColour, uint16_t BackColour);
+void hud_invalidate(HudNumber *Field);
+void hud_setNumber(HudNumber *Field, uint16_t Value);
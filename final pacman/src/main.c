@@ -1,1356 +1,1721 @@
-/******************************************************************************
- * Heart Chaser - Embedded Systems Game
- ******************************************************************************
- * File:    main.c
- * Course:  TU857-2 Microprocessor Systems
- * School:  Technological University Dublin
- * Term:    Semester 1, 2024-25
- * 
- * Authors: Vengie Legaspi
- *          Cristian [Last Name]
- *          John [Last Name]
- *
- * Date:    November 6, 2024
- * 
- * Description:
- *     A maze-based game where the player chases and collects hearts while
- *     avoiding enemy pumpkins. Features multiple levels, sound effects,
- *     and animated sprites. Developed for STM32F031 microcontroller.
- * 
- * Hardware:
- *     - STM32F031 MCU
- *     - LCD Display
- *     - 4 Directional Buttons
- *     - Speaker for Sound Effects
- *****************************************************************************/
-
-/******************************************************************************
- * Include Files
- *****************************************************************************/
-#include <string.h>       // Required for string operations (strlen for text centering)
-#include <stm32f031x6.h>  // STM32 microcontroller specific definitions
-#include "display.h"      // LCD display functions
-#include <stdlib.h>       // Required for random number generation (heart movement)
-#include "sound.h"        // Sound effect functions for eating hearts
-#include "musical_notes.h"// Musical note definitions for sound effects
-#include "serial.h"       // Serial communication functions
-#include <stdio.h>        // Standard I/O (sprintf for text formatting)
-
-/******************************************************************************
- * Function Prototypes
- *****************************************************************************/
-// Core game rendering functions
-void drawBackground(void);        // Draws the maze and background
-void showWinScreen(void);         // Displays the victory screen
-void initEnemies(void);           // Sets up enemy positions and properties
-void checkWinCondition(uint16_t x, uint16_t y);  // Checks if level is complete
-void moveEnemies(uint16_t pacman_x, uint16_t pacman_y);  // Updates enemy positions
-int checkEnemyCollision(uint16_t pacman_x, uint16_t pacman_y);  // Detects player-enemy collisions
-
-// Menu and UI functions
-void drawGameOverMenu(void);      // Shows game over screen
-void drawMenu(void);              // Displays main menu
-void showControls(void);          // Shows game controls
-void showCredits(void);           // Displays game credits
-
-/******************************************************************************
- * Game Constants
- *****************************************************************************/
-// Game configuration
-#define MAX_ENEMIES 6    // Number of pumpkin enemies (increased from 3 to 6)
-#define MAX_HEARTS 6     // Maximum number of collectible hearts in final level
-
-// Maze appearance constants
-#define WALL_COLOR RGBToWord(0, 0, 255)  // Blue color for maze walls
-#define PATH_COLOR RGBToWord(0, 0, 20)   // Dark background color for paths
-#define WALL_SIZE 8                      // Size of each wall block in pixels
-
-// Victory screen colors
-#define WIN_GOLD RGBToWord(0xFF, 0xD7, 0x00)  // Golden color for victory effects
-#define WIN_PINK RGBToWord(0xFF, 0x69, 0xB4)  // Pink color for victory effects
-#define WIN_BLUE RGBToWord(0x00, 0xBF, 0xFF)  // Sky blue for victory effects
-
-// Menu color scheme
-#define TITLE_COLOR RGBToWord(0xff, 0x1a, 0x1a)  // Bright red for titles
-#define SELECTED_COLOR RGBToWord(0xff, 0xff, 0)   // Yellow for selected items
-#define UNSELECTED_COLOR RGBToWord(0, 0xff, 0)    // Green for unselected items
-#define BORDER_COLOR RGBToWord(0, 0, 0xff)        // Blue for borders
-
-/******************************************************************************
- * Sound Variables
- *****************************************************************************/
-// Background music variables
-const uint32_t *background_tune_notes;    // Pointer to background music notes
-const uint32_t *background_tune_times;    // Pointer to note durations
-uint32_t background_tune_note_count;      // Number of notes in background music
-uint32_t background_repeat_tune;          // Flag to loop background music
-uint32_t pumpkin_move_delay = 0;         // Timer for enemy movement
-
-// Sound effect variables
-const uint32_t my_notes[] = {A3,C5,B2,D1,F6};  // Notes for sound effects
-const uint32_t my_note_times[] = {200,300,400,100,500};  // Duration of each note
-uint32_t repeat_tune;  // Flag to repeat sound effect
-
-/******************************************************************************
- * Game State Variables
- *****************************************************************************/
-// Core game state
-int game_won = 0;              // Tracks if player has won
-int game_over = 0;             // Tracks if game is over
-int show_game_over_menu = 0;   // Controls game over menu visibility
-int game_over_selection = 0;   // Menu selection (0=Play Again, 1=Main Menu)
-
-/******************************************************************************
- * System Function Prototypes
- *****************************************************************************/
-void initClock(void);          // Initialize system clock
-void initSysTick(void);        // Initialize system timer
-void SysTick_Handler(void);    // System tick interrupt handler
-void delay(volatile uint32_t dly);  // Time delay function
-void setupIO();                // Initialize IO pins
-int isInside(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h, 
-             uint16_t px, uint16_t py);  // Collision detection
-void enablePullUp(GPIO_TypeDef *Port, uint32_t BitNumber);  // GPIO pull-up config
-void pinMode(GPIO_TypeDef *Port, uint32_t BitNumber, uint32_t Mode);  // GPIO mode config
-
-/******************************************************************************
- * Game Object Variables
- *****************************************************************************/
-// System timing
-volatile uint32_t milliseconds;  // System time counter
-
-// Heart positions and states - Level 1
-uint16_t heart1_x = 40, heart1_y = 80;  // Heart 1 position
-uint16_t heart2_x = 60, heart2_y = 90;  // Heart 2 position
-int heart1_direction_x = 1;             // Heart 1 movement direction
-int heart1_direction_y = 1;
-int heart2_direction_x = 1;             // Heart 2 movement direction
-int heart2_direction_y = 1;
-uint32_t heart_move_delay = 0;          // Heart movement timer
-int heart1_eaten = 0;                   // Heart collection status
-int heart2_eaten = 0;
-
-// Level tracking
-int current_level = 1;         // Current game level (now goes to 3)
-int hearts_collected = 0;      // Total hearts collected
-
-// Heart positions and states - Level 2 & 3
-uint16_t heart3_x = 80, heart3_y = 70;  // Heart 3 position
-uint16_t heart4_x = 30, heart4_y = 100; // Heart 4 position
-uint16_t heart5_x = 90, heart5_y = 110; // Heart 5 position (new)
-uint16_t heart6_x = 20, heart6_y = 60;  // Heart 6 position (new)
-int heart3_eaten = 0;                   // Heart collection status
-int heart4_eaten = 0;
-int heart5_eaten = 0;                   // New heart status
-int heart6_eaten = 0;                   // New heart status
-int heart3_direction_x = 1, heart3_direction_y = 1;  // Movement directions
-int heart4_direction_x = 1, heart4_direction_y = 1;
-int heart5_direction_x = 1, heart5_direction_y = 1;  // New heart movement
-int heart6_direction_x = 1, heart6_direction_y = 1;  // New heart movement
-
-// Boss enemy variables (new)
-typedef struct {
-    uint16_t x;
-    uint16_t y;
-    int active;
-    int speed;
-    int size;  // Boss is larger than regular enemies
-} Boss;
-
-Boss boss = {64, 80, 0, 2, 24};  // Boss initialization
-
-/******************************************************************************
- * Sprite Definitions
- *****************************************************************************/
-// Pacman sprite facing right 
-const uint16_t pac1[]=
-{
-0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,16384,0,0,0,0,0,0,0,0,0,0,0,61507,46885,3907,52555,4668,0,0,0,0,0,61756,23062,24327,24327,24327,24327,12099,64782,40960,0,0,0,63013,24327,24327,65535,24327,24327,23566,31006,37436,0,16384,63005,24327,61507,24327,24327,40871,40871,40871,40871,40871,0,0,37940,4916,54573,24327,40871,0,0,0,0,0,0,57344,46132,13869,54324,37180,24327,40871,40871,40871,40871,40871,0,0,0,36427,38693,38693,24327,24327,24327,24327,16135,31510,0,0,0,53820,44867,23062,37940,21805,39446,63517,39446,16384,0,0,0,0,0,54068,13357,53564,61251,53315,24576,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-const uint16_t pacman2[]= 
-{
-0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,16384,32768,32768,32768,24576,0,0,0,0,0,0,0,53315,21549,38693,31006,62765,0,0,0,0,0,24327,23062,24327,24327,7687,40711,31510,64030,30757,0,0,0,63013,24327,24327,65535,24327,24327,24327,24487,32423,0,264,54573,24327,61507,24327,24327,24327,40871,40871,0,0,0,0,54316,4916,54573,24327,40871,40871,0,0,0,0,0,57344,46132,13869,54324,37180,24327,24327,40871,40871,0,0,0,0,0,36427,38693,38693,39446,4668,24327,7943,32679,40871,0,0,0,24327,44867,23062,37940,21805,31758,47133,47390,55325,49152,0,0,0,0,54068,13357,53564,61251,53315,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-const uint16_t pacman3top[]= 
-{
-0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,24576,24576,8192,0,0,0,0,0,0,0,0,6405,30733,30733,47373,8192,0,0,0,0,0,0,22789,54805,22037,30229,30477,63749,0,0,0,0,24576,22541,13596,54044,62236,29468,46108,38164,63501,8192,0,16384,63501,13845,4644,20523,12331,20772,36899,37916,21780,30477,0,24576,22285,54548,12580,4139,52779,3883,45091,54300,21780,30229,40960,16384,22285,29972,12580,36651,20267,20267,61731,13084,13845,30229,40960,0,0,29972,4644,4388,53796,4644,21028,21780,30229,0,0,0,0,0,22037,29724,5148,54548,5909,14349,0,0,0,0,0,0,0,55309,62997,14093,30981,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-const uint16_t pacmanheart[]=
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,23568,23568,0,0,23568,23568,0,0,0,0,0,23568,23568,23568,0,0,23568,23568,23568,0,0,0,39952,23081,6945,23568,23568,23568,23568,23568,23568,23568,0,0,23568,6945,14906,64049,48144,23568,23568,23568,23568,23568,0,0,23568,39960,31529,14898,23568,23568,23568,23568,23568,23568,0,0,23568,23568,23568,31768,23568,23568,23568,23568,23568,23568,0,0,0,23568,23568,23568,23568,23568,23568,23568,23568,0,0,0,0,0,23568,23568,23568,23568,23568,23568,0,0,0,0,0,0,0,0,23568,23568,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-const uint16_t pacmanheart2[]=
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,23568,23568,0,0,23568,23568,0,0,0,0,0,23568,23568,23568,0,0,23568,23568,23568,0,0,0,39952,23081,6945,23568,23568,23568,23568,23568,23568,23568,0,0,23568,6945,14906,64049,48144,23568,23568,23568,23568,23568,0,0,23568,39960,31529,14898,23568,23568,23568,23568,23568,23568,0,0,23568,23568,23568,31768,23568,23568,23568,23568,23568,23568,0,0,0,23568,23568,23568,23568,23568,23568,23568,23568,0,0,0,0,0,23568,23568,23568,23568,23568,23568,0,0,0,0,0,0,0,0,23568,23568,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-// Pumpkin sprite - a scary 12x16 jack-o'-lantern
-const uint16_t pumpkin_sprite[] = {
-    0,0,0,0,2016,2016,2016,2016,0,0,0,0,    // Green stem
-    0,0,2016,2016,2016,2016,2016,2016,2016,2016,0,0,
-    0,64800,64800,2016,2016,2016,2016,2016,2016,64800,64800,0,  // Orange body starts
-    64800,64800,64800,64800,64800,64800,64800,64800,64800,64800,64800,64800,
-    64800,65535,64800,65535,64800,64800,65535,64800,65535,64800,64800,64800,  // Evil eyes
-    64800,65535,64800,65535,64800,64800,65535,64800,65535,64800,64800,64800,
-    64800,64800,64800,64800,64800,64800,64800,64800,64800,64800,64800,64800,
-    64800,64800,64800,64800,0,0,64800,64800,64800,64800,64800,64800,  // Evil grin starts
-    64800,64800,64800,0,65535,65535,0,64800,64800,64800,64800,64800,
-    64800,64800,0,65535,65535,65535,65535,0,64800,64800,64800,64800,
-    64800,64800,65535,65535,65535,65535,65535,65535,64800,64800,64800,64800,
-    64800,64800,65535,0,65535,65535,0,65535,64800,64800,64800,64800,
-    64800,64800,0,0,0,0,0,0,64800,64800,64800,64800,
-    0,64800,64800,64800,64800,64800,64800,64800,64800,64800,64800,0,
-    0,0,64800,64800,64800,64800,64800,64800,64800,64800,0,0,
-    0,0,0,64800,64800,64800,64800,64800,64800,0,0,0
-};
-
-/******************************************************************************
- * Enemy Structure Definition
- *****************************************************************************/
-// Structure to track enemy properties
-typedef struct {
-    uint16_t x;       // X position on screen
-    uint16_t y;       // Y position on screen
-    int active;       // Whether enemy is currently active
-    int speed;        // Movement speed of enemy
-} Enemy;
-Enemy enemies[MAX_ENEMIES];  // Array to hold all enemy instances
-
-
-// Ghost sprite - a cute 12x16 ghost shape
-/*const uint16_t ghost_sprite[] = {
-    0,0,0,0,63488,63488,63488,63488,0,0,0,0,
-    0,0,63488,63488,63488,63488,63488,63488,63488,63488,0,0,
-    0,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,0,
-    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
-    63488,63488,65535,65535,63488,63488,65535,65535,63488,63488,63488,63488,
-    63488,63488,65535,65535,63488,63488,65535,65535,63488,63488,63488,63488,
-    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
-    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
-    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
-    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
-    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
-    63488,0,63488,63488,0,63488,63488,0,63488,63488,0,63488,
-    0,0,0,63488,0,0,63488,0,0,63488,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0
-};*/
-
-/******************************************************************************
- * Enemy Management Functions
- *****************************************************************************/
-/**
- * Initializes enemies for each level
- * Sets initial positions, activation status, and speeds
- */
-void initEnemies() {
-    if (current_level == 1) {
-        // Level 1: Single enemy setup
-        enemies[0].x = 10;            // Starting X position
-        enemies[0].y = 10;            // Starting Y position
-        enemies[0].active = 1;        // Activate enemy
-        enemies[0].speed = 1;         // Base movement speed
-    } else {
-        // Level 2: Three enemies with adjusted positions
-        // First enemy
-        enemies[0].x = 10;
-        enemies[0].y = 10;
-        enemies[0].active = 1;
-        enemies[0].speed = 1;
-
-        // Second enemy
-        enemies[1].x = 100;
-        enemies[1].y = 10;
-        enemies[1].active = 1;
-        enemies[1].speed = 1;
-
-        // Third enemy
-        enemies[2].x = 60;
-        enemies[2].y = 140;
-        enemies[2].active = 1;
-        enemies[2].speed = 1;
-    }
-
-    // Draw all active enemies in their initial positions
-    for(int i = 0; i < (current_level == 1 ? 1 : MAX_ENEMIES); i++) {
-        if(enemies[i].active) {
-            putImage(enemies[i].x, enemies[i].y, 12, 16, pumpkin_sprite, 0, 0);
-        }
-    }
-}
-
-/******************************************************************************
- * Sound Functions
- *****************************************************************************/
-/**
- * Plays a sequence of musical notes
- * @param notes: Array of note frequencies
- * @param times: Array of note durations
- * @param len: Length of the arrays
- */
-void playTune(const uint32_t notes[], const uint32_t times[], int len) {
-    for (int i=0; i<len; i++) {
-        playNote(notes[i]);
-        delay(times[i]);
-    }
-    playNote(0);  // Stop sound
-}
-
-/******************************************************************************
- * Enemy Movement Functions
- *****************************************************************************/
-/**
- * Updates enemy positions relative to player location
- * @param pacman_x: Player's X coordinate
- * @param pacman_y: Player's Y coordinate
- */
-void moveEnemies(uint16_t pacman_x, uint16_t pacman_y) {
-    if (game_won) return;  // Skip if game is won
-
-    // Set movement delay based on level
-    uint32_t delay_time = (current_level == 1) ? 30 : 65;
-    
-    // Control movement timing
-    if (milliseconds - pumpkin_move_delay < delay_time) {
-        return;
-    }
-    pumpkin_move_delay = milliseconds;
-    
-    // Update each enemy's position
-    for(int i = 0; i < MAX_ENEMIES; i++) {
-        if(enemies[i].active) {
-            // Clear previous position
-            fillRectangle(enemies[i].x, enemies[i].y, 12, 16, 0);
-            
-            // Calculate movement speed based on level
-            int current_speed;
-            if (current_level == 2) {
-                // Slower movement in level 2
-                current_speed = (milliseconds % 2 == 0) ? 1 : 0;
-            } else {
-                current_speed = enemies[i].speed;
-            }
-            
-            // Move toward player
-            if(enemies[i].x < pacman_x) enemies[i].x += current_speed;
-            if(enemies[i].x > pacman_x) enemies[i].x -= current_speed;
-            if(enemies[i].y < pacman_y) enemies[i].y += current_speed;
-            if(enemies[i].y > pacman_y) enemies[i].y -= current_speed;
-            
-            // Enforce screen boundaries
-            enemies[i].x = (enemies[i].x <= 0) ? 0 : 
-                          (enemies[i].x >= 115) ? 115 : enemies[i].x;
-            enemies[i].y = (enemies[i].y <= 0) ? 0 : 
-                          (enemies[i].y >= 144) ? 144 : enemies[i].y;
-            
-            // Draw at new position
-            putImage(enemies[i].x, enemies[i].y, 12, 16, pumpkin_sprite, 0, 0);
-        }
-    }
-}
-
-/**
- * Checks for collision between player and enemies
- * @param pacman_x: Player's X coordinate
- * @param pacman_y: Player's Y coordinate
- * @return: 1 if collision detected, 0 otherwise
- */
-int checkEnemyCollision(uint16_t pacman_x, uint16_t pacman_y) {
-    for(int i = 0; i < MAX_ENEMIES; i++) {
-        if(enemies[i].active && 
-           isInside(enemies[i].x, enemies[i].y, 12, 16, pacman_x, pacman_y)) {
-            return 1;
-        }
-    }
-    return 0;
-}
-
-/******************************************************************************
- * Game Logic Functions
- *****************************************************************************/
-/**
- * Checks if level/game completion conditions are met
- * @param x: Player's X coordinate
- * @param y: Player's Y coordinate
- */
-void checkWinCondition(uint16_t x, uint16_t y) {
-    // Calculate required hearts based on level
-    int required_hearts = (current_level == 1) ? 2 : 4;
-    hearts_collected = heart1_eaten + heart2_eaten;
-    if (current_level == 2) {
-        hearts_collected += heart3_eaten + heart4_eaten;
-    }
-
-    // Check win conditions
-    if (hearts_collected == required_hearts && !game_won) {
-        if (current_level == 1) {
-            // Advance to level 2
-            current_level = 2;
-            heart1_eaten = heart2_eaten = heart3_eaten = heart4_eaten = 0;
-            fillRectangle(0, 0, 128, 160, 0);
-            printTextX2("LEVEL 2!", 25, 60, RGBToWord(0, 0xff, 0), 0);
-            delay(2000);
-            initEnemies();
-            drawBackground();
-            x = 50; y = 50;  // Reset player position
-        } else {
-            // Complete game victory
-            game_won = 1;
-            showWinScreen();
-        }
-    }
-}
-
-/**
- * Resets heart positions when game ends
- * @param pacman_x: Player's X coordinate
- * @param pacman_y: Player's Y coordinate
- */
-void clearHearts(int pacman_x, int pacman_y) {
-    // Reset hearts not collected by player
-    if (pacman_x != heart1_x || pacman_y != heart1_y) {
-        heart1_x = 40; heart1_y = 80;
-    }
-    if (pacman_x != heart2_x || pacman_y != heart2_y) {
-        heart2_x = 60; heart2_y = 90;
-    }
-}
-
-/******************************************************************************
- * Maze Definitions and Drawing
- *****************************************************************************/
-
-// The maze layout (1 = wall, 0 = path)
-const uint8_t maze[20][16] = {
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
-    {1,0,1,1,1,0,1,0,1,1,1,1,1,1,0,1},
-    {1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,1},
-    {1,1,1,0,1,1,1,1,1,0,1,0,1,1,0,1},
-    {1,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1},
-    {1,0,1,1,1,1,1,0,1,1,1,1,1,0,1,1},
-    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
-    {1,1,1,1,1,0,1,1,1,1,1,0,1,1,0,1},
-    {1,0,0,0,0,0,1,0,0,0,0,0,1,0,0,1},
-    {1,0,1,1,1,1,1,0,1,1,1,1,1,0,1,1},
-    {1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1},
-    {1,0,1,1,1,1,1,1,1,0,1,1,1,1,0,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1},
-    {1,0,1,1,1,1,1,1,1,1,1,1,0,1,0,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
-};
-
-// New maze layout for level 2
-const uint8_t maze_level2[20][16] = {
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-    {1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,1},
-    {1,0,1,0,1,0,1,1,1,0,1,0,1,1,0,1},
-    {1,0,1,0,0,0,0,0,1,0,0,0,0,1,0,1},
-    {1,0,1,1,1,1,1,0,1,1,1,1,0,1,0,1},
-    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
-    {1,1,1,1,1,0,1,1,1,0,1,1,1,1,0,1},
-    {1,0,0,0,1,0,0,0,1,0,1,0,0,0,0,1},
-    {1,0,1,0,1,1,1,0,1,0,1,0,1,1,1,1},
-    {1,0,1,0,0,0,0,0,0,0,1,0,0,0,0,1},
-    {1,0,1,1,1,1,1,1,1,1,1,1,1,1,0,1},
-    {1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,1},
-    {1,0,1,1,1,0,1,0,1,1,1,1,0,1,0,1},
-    {1,0,0,0,1,0,0,0,1,0,0,0,0,0,0,1},
-    {1,1,1,0,1,1,1,1,1,0,1,1,1,1,0,1},
-    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
-};
-
-
-/******************************************************************************
- * Background and Maze Drawing Functions
- *****************************************************************************/
-/**
- * Draws the game background and maze walls
- * Handles both level 1 and level 2 maze layouts
- */
-void drawBackground(void) {
-    // Set entire background to path color
-    fillRectangle(0, 0, 128, 160, PATH_COLOR);
-    
-    // Select maze layout based on current level
-    const uint8_t (*current_maze)[16] = (current_level == 1) ? maze : maze_level2;
-    
-    // Iterate through maze array and draw walls
-    for(int y = 0; y < 20; y++) {
-        for(int x = 0; x < 16; x++) {
-            if(current_maze[y][x] == 1) {
-                // Draw wall block at calculated position
-                fillRectangle(x * WALL_SIZE, y * WALL_SIZE, 
-                            WALL_SIZE, WALL_SIZE, WALL_COLOR);
-            }
-        }
-    }
-}
-
-/**
- * Checks if a given position collides with maze walls
- * @param x: X coordinate to check
- * @param y: Y coordinate to check
- * @return: 1 if collision detected, 0 if path is clear
- */
-int isWallCollision(uint16_t x, uint16_t y) {
-    // Convert pixel coordinates to maze grid coordinates
-    int gridX = x / WALL_SIZE;
-    int gridY = y / WALL_SIZE;
-    
-    // Check if position is within maze bounds
-    if(gridX >= 0 && gridX < 16 && gridY >= 0 && gridY < 20) {
-        return maze[gridY][gridX] == 1;
-    }
-    return 1;  // Treat out-of-bounds as wall collision
-}
-
-/******************************************************************************
- * Menu System Variables and Functions
- *****************************************************************************/
-// Menu state tracking
-int in_menu = 1;           // Start in menu state
-int selected_option = 0;   // Currently selected menu option
-#define NUM_MENU_OPTIONS 3 // Total number of menu options
-
-/**
- * Draws decorative border around menu screens
- */
-void drawMenuBorder() {
-    // Draw horizontal borders
-    for(int i = 0; i < 128; i++) {
-        putPixel(i, 0, BORDER_COLOR);      // Top border
-        putPixel(i, 159, BORDER_COLOR);    // Bottom border
-    }
-    // Draw vertical borders
-    for(int i = 0; i < 160; i++) {
-        putPixel(0, i, BORDER_COLOR);      // Left border
-        putPixel(127, i, BORDER_COLOR);    // Right border
-    }
-}
-
-/**
- * Draws main menu screen with animated elements
- */
-void drawMenu() {
-    // Create gradient background effect
-    for(int y = 0; y < 160; y++) {
-        uint16_t color = RGBToWord(0, 0, (y/2) % 32);
-        for(int x = 0; x < 128; x++) {
-            putPixel(x, y, color);
-        }
-    }
-    
-    drawMenuBorder();  // Add border
-    
-    // Add decorative hearts in corners
-    putImage(5, 5, 12, 16, pacmanheart, 0, 0);     // Top-left
-    putImage(111, 5, 12, 16, pacmanheart, 0, 0);   // Top-right
-    putImage(5, 139, 12, 16, pacmanheart, 0, 0);   // Bottom-left
-    putImage(111, 139, 12, 16, pacmanheart, 0, 0); // Bottom-right
-    
-    // Draw title with shadow effect
-    printTextX2("HEART", 36, 21, 0, 0);            // Shadow
-    printTextX2("HEART", 35, 20, TITLE_COLOR, 0);  // Main text
-    printTextX2("CHASE", 36, 41, 0, 0);            // Shadow
-    printTextX2("CHASE", 35, 40, TITLE_COLOR, 0);  // Main text
-    
-    // Add separator line
-    for(int i = 20; i < 108; i++) {
-        putPixel(i, 65, BORDER_COLOR);
-    }
-    
-    // Menu options with animation
-    const char* options[] = {"Start Game", "Controls", "Credits"};
-    static int animation_offset = 0;
-    animation_offset = (animation_offset + 1) % 4;
-    
-    // Draw each menu option
-    for(int i = 0; i < NUM_MENU_OPTIONS; i++) {
-        uint16_t color = (i == selected_option) ? SELECTED_COLOR : UNSELECTED_COLOR;
-        int y_pos = 80 + (i * 20);
-        
-        // Animated selection box for current option
-        if(i == selected_option) {
-            int box_x = 35 - animation_offset;
-            int box_width = 60 + (animation_offset * 2);
-            fillRectangle(box_x, y_pos - 2, box_width, 12, RGBToWord(0, 0, 32));
-        }
-        
-        printText(options[i], 40, y_pos, color, 0);
-    }
-    
-    // Animated Pacman indicator
-    static int pac_toggle = 0;
-    pac_toggle ^= 1;
-    putImage(20, 78 + (selected_option * 20), 12, 16, 
-             pac_toggle ? pac1 : pacman2, 0, 0);
-}
-
-/**
- * Displays game controls screen
- */
-void showControls() {
-    fillRectangle(0, 0, 128, 160, 0);  // Clear screen
-    drawMenuBorder();
-    
-    // Title with shadow
-    printTextX2("CONTROLS", 21, 21, 0, 0);           // Shadow
-    printTextX2("CONTROLS", 20, 20, TITLE_COLOR, 0); // Main text
-    
-    // Separator lines
-    for(int i = 20; i < 108; i++) {
-        putPixel(i, 35, BORDER_COLOR);
-        putPixel(i, 120, BORDER_COLOR);
-    }
-    
-    // Control instructions
-    printText("Movement:", 20, 45, SELECTED_COLOR, 0);
-    printText("↑ Up Arrow", 30, 60, UNSELECTED_COLOR, 0);
-    printText("↓ Down Arrow", 30, 75, UNSELECTED_COLOR, 0);
-    printText("← Left Arrow", 30, 90, UNSELECTED_COLOR, 0);
-    printText("→ Right Arrow", 30, 105, UNSELECTED_COLOR, 0);
-    
-    // Blinking return instruction
-    static int blink = 0;
-    blink ^= 1;
-    if(blink) {
-        printText("Press RIGHT to return", 15, 130, SELECTED_COLOR, 0);
-    }
-}
-
-/**
- * Displays credits screen
- */
-void showCredits() {
-    fillRectangle(0, 0, 128, 160, 0);  // Clear screen
-    drawMenuBorder();
-    
-    // Title with shadow
-    printTextX2("CREDITS", 31, 21, 0, 0);           // Shadow
-    printTextX2("CREDITS", 30, 20, TITLE_COLOR, 0); // Main text
-    
-    // Separator lines
-    for(int i = 20; i < 108; i++) {
-        putPixel(i, 35, BORDER_COLOR);
-        putPixel(i, 120, BORDER_COLOR);
-    }
-    
-    // Credits content
-    printText("Heart Chase", 30, 50, SELECTED_COLOR, 0);
-    printText("Created by:", 30, 70, UNSELECTED_COLOR, 0);
-    printText("V, C, J", 35, 85, SELECTED_COLOR, 0);
-    
-    // Blinking return instruction
-    static int blink = 0;
-    blink ^= 1;
-    if(blink) {
-        printText("Press RIGHT to return", 15, 130, SELECTED_COLOR, 0);
-    }
-    
-    // Decorative hearts
-    putImage(10, 45, 12, 16, pacmanheart, 0, 0);   // Left heart
-    putImage(106, 45, 12, 16, pacmanheart, 0, 0);  // Right heart
-}
-
-/******************************************************************************
- * Game Over and Victory Screen Functions
- *****************************************************************************/
-
-/**
- * Displays the game over or victory menu
- * Allows player to choose between replaying or returning to main menu
- */
-void drawGameOverMenu() {
-    // Create dark background panel
-    fillRectangle(20, 50, 88, 60, RGBToWord(0, 0, 32));
-    
-    // Draw decorative border around panel
-    for(int i = 20; i < 108; i++) {
-        putPixel(i, 50, RGBToWord(0, 0, 0xff));   // Top border
-        putPixel(i, 110, RGBToWord(0, 0, 0xff));  // Bottom border
-    }
-    for(int i = 50; i < 110; i++) {
-        putPixel(20, i, RGBToWord(0, 0, 0xff));   // Left border
-        putPixel(107, i, RGBToWord(0, 0, 0xff));  // Right border
-    }
-    
-    // Display appropriate status message
-    if (game_won) {
-        printText("YOU WIN!", 40, 60, RGBToWord(0, 0xff, 0), 0);  // Green for win
-    } else {
-        printText("GAME OVER", 35, 60, RGBToWord(0xff, 0, 0), 0); // Red for loss
-    }
-    
-    // Set colors for menu options based on selection
-    uint16_t play_color = (game_over_selection == 0) ? 
-        RGBToWord(0xff, 0xff, 0) : RGBToWord(0xff, 0xff, 0xff);  // Yellow/White
-    uint16_t menu_color = (game_over_selection == 1) ? 
-        RGBToWord(0xff, 0xff, 0) : RGBToWord(0xff, 0xff, 0xff);  // Yellow/White
-    
-    // Draw menu options
-    printText("Play Again", 35, 80, play_color, 0);
-    printText("Main Menu", 35, 95, menu_color, 0);
-    
-    // Draw Pacman indicator for current selection
-    putImage(25, 78 + (game_over_selection * 15), 12, 16, pac1, 0, 0);
-}
-
-/**
- * Displays an animated victory celebration screen
- * Shows congratulatory messages and final score
- */
-void showWinScreen() {
-    // Create animated gradient background
-    for(int y = 0; y < 160; y++) {
-        uint16_t color = RGBToWord(0, 0, (y/2) % 64);  // Dark blue gradient
-        for(int x = 0; x < 128; x++) {
-            putPixel(x, y, color);
-        }
-    }
-
-    // Play victory fanfare
-    playNote(800);  delay(200);  // Low note
-    playNote(1000); delay(200);  // Mid-low note
-    playNote(1200); delay(200);  // Mid-high note
-    playNote(1500); delay(400);  // High note
-    playNote(0);                 // Stop sound
-
-    // Draw golden decorative border
-    for(int i = 0; i < 128; i++) {
-        putPixel(i, 0, WIN_GOLD);    // Top border
-        putPixel(i, 159, WIN_GOLD);  // Bottom border
-    }
-    for(int i = 0; i < 160; i++) {
-        putPixel(0, i, WIN_GOLD);    // Left border
-        putPixel(127, i, WIN_GOLD);  // Right border
-    }
-
-    // Animate hearts appearing in corners
-    for(int i = 0; i < 4; i++) {
-        delay(100);  // Pause between each heart
-        switch(i) {
-            case 0: putImage(5, 5, 12, 16, pacmanheart, 0, 0);     // Top-left
-            case 1: putImage(111, 5, 12, 16, pacmanheart, 0, 0);   // Top-right
-            case 2: putImage(5, 139, 12, 16, pacmanheart, 0, 0);   // Bottom-left
-            case 3: putImage(111, 139, 12, 16, pacmanheart, 0, 0); // Bottom-right
-        }
-    }
-
-    // Display main victory text with shadow effect
-    const char* win_text = "YOU WIN!";
-    int text_x = 25;
-    int text_y = 40;
-    
-    printTextX2(win_text, text_x + 1, text_y + 1, 0, 0);      // Shadow
-    printTextX2(win_text, text_x, text_y, WIN_GOLD, 0);       // Main text
-    
-    delay(500);  // Pause for emphasis
-
-    // Animate separator lines
-    for(int i = 20; i < 108; i++) {
-        putPixel(i, 65, WIN_PINK);           // Upper line
-        putPixel(107-i+20, 95, WIN_PINK);    // Lower line
-        if(i % 4 == 0) delay(1);             // Slow animation
-    }
-
-    // Display congratulatory messages with fade-in effect
-    const char* messages[] = {
-        "CONGRATULATIONS!",
-        "ALL HEARTS",
-        "COLLECTED!",
-        "YOU'RE Eating!"
-    };
-    
-    // Show each message with alternating colors
-    for(int i = 0; i < 4; i++) {
-        delay(200);  // Pause between messages
-        int y_pos = 70 + (i * 20);
-        printText(messages[i], 
-                 64 - (strlen(messages[i]) * 3), // Center text
-                 y_pos, 
-                 (i % 2) ? WIN_PINK : WIN_BLUE,  // Alternate colors
-                 0);
-    }
-
-    // Display final level count
-    delay(200);
-    char score_text[20];
-    sprintf(score_text, "LEVELS: %d", current_level);
-    printText(score_text, 40, 140, WIN_GOLD, 0);
-
-    // Log victory to serial output
-    eputs("Game Won! All hearts collected in both levels!\r\n");
-}
-/******************************************************************************
- * Main Function - Game Initialization
- *****************************************************************************/
-int main() {
-    // Movement and direction control flags
-    int hinverted = 0;    // Horizontal flip flag
-    int vinverted = 0;    // Vertical flip flag
-    int toggle = 0;       // Animation toggle
-    int hmoved = 0;       // Horizontal movement flag
-    int vmoved = 0;       // Vertical movement flag
-    
-    // Player position tracking
-    uint16_t x = 50;      // Current X position
-    uint16_t y = 50;      // Current Y position
-    uint16_t oldx = x;    // Previous X position
-    uint16_t oldy = y;    // Previous Y position
-
-    /*** Hardware Initialization ***/
-    initClock();          // Initialize system clock
-    initSysTick();        // Initialize system timer
-    setupIO();            // Setup input/output pins
-    initSerial();         // Initialize serial communication
-    initEnemies();        // Initialize enemy positions and states
-    //initSound();
-
-    /*** Initial Game Setup ***/
-    // Place hearts in starting positions
-    putImage(heart1_x, heart1_y, 12, 16, pacmanheart, 0, 0);   // First heart
-    putImage(heart2_x, heart2_y, 12, 16, pacmanheart2, 0, 0);  // Second heart
-
-    /*** Sound System Setup ***/
-    // Play startup tune
-    playTune(my_notes, my_note_times, 5);
-    
-    // Configure background music
-    background_tune_notes = my_notes;
-    background_tune_times = my_note_times;
-    background_tune_note_count = 5;
-    background_repeat_tune = 1;
-
-    /*** Draw Initial Game Screen ***/
-    drawBackground();     // Draw maze and game environment
-
-/******************************************************************************
- * Main Game Loop
- *****************************************************************************/
-    while (1) {
-        // Handle serial input
-        char serial_char = serial_available() ? egetchar() : 0;
-
-        /*** Menu State Handling ***/
-        if (in_menu) {
-            // Draw menu on first entry
-            static int menu_drawn = 0;
-            if (!menu_drawn) {
-                drawMenu();
-                menu_drawn = 1;
-            }
-
-            // Menu Navigation Controls
-            // Down Button
-            if ((GPIOA->IDR & (1 << 11)) == 0) {
-                delay(200);  // Prevent multiple inputs
-                selected_option = (selected_option + 1) % NUM_MENU_OPTIONS;
-                drawMenu();
-            }
-            // Up Button
-            if ((GPIOA->IDR & (1 << 8)) == 0) {
-                delay(200);
-                selected_option = (selected_option - 1 + NUM_MENU_OPTIONS) % NUM_MENU_OPTIONS;
-                drawMenu();
-            }
-            // Select Button (Right/Enter)
-            if ((GPIOB->IDR & (1 << 4)) == 0) {
-                delay(200);
-                
-                switch(selected_option) {
-                    case 0:  // Start New Game
-                        // Reset game state and screen
-                        in_menu = 0;
-                        menu_drawn = 0;
-                        fillRectangle(0, 0, 128, 160, 0);  // Clear screen
-                        drawBackground();                   // Draw maze
-                        initEnemies();                     // Setup enemies
-                        
-                        // Reset game flags
-                        game_over = 0;
-                        game_won = 0;
-                        heart1_eaten = 0;
-                        heart2_eaten = 0;
-                        
-                        // Reset positions
-                        x = 50; y = 50;           // Player position
-                        oldx = x; oldy = y;       // Previous position
-                        heart1_x = 40; heart1_y = 80;  // Heart 1 position
-                        heart2_x = 60; heart2_y = 90;  // Heart 2 position
-                        
-                        // Draw hearts
-                        putImage(heart1_x, heart1_y, 12, 16, pacmanheart, 0, 0);
-                        putImage(heart2_x, heart2_y, 12, 16, pacmanheart2, 0, 0);
-                        break;
-                        
-                    case 1:  // Show Controls Screen
-                        showControls();
-                        while((GPIOB->IDR & (1 << 4)) != 0) {}  // Wait for button release
-                        delay(200);
-                        drawMenu();
-                        break;
-                        
-                    case 2:  // Show Credits Screen
-                        showCredits();
-                        while((GPIOB->IDR & (1 << 4)) != 0) {}
-                        delay(200);
-                        drawMenu();
-                        break;
-                }
-            }
-            continue;  // Skip game logic while in menu
-        }
-
-        /*** Game State Updates ***/
-        hmoved = vmoved = 0;           // Reset movement flags
-        hinverted = vinverted = 0;     // Reset direction flags
-        
-        checkWinCondition(x, y);       // Check if level complete
-        if(!game_won) {
-            moveEnemies(x, y);         // Update enemy positions
-        }
-
-        /*** Player Movement ***/
-        if (!game_over && !game_won) {
-            // Right Movement
-            if (((GPIOB->IDR & (1 << 4)) == 0) || (serial_char == 'r')) {
-                if (x < 115) {
-                    x = x + 1;
-                    hmoved = 1;
-                    hinverted = 0;
-                }
-            }
-            // Left Movement
-            if ((GPIOB->IDR & (1 << 5)) == 0) {
-                if (x > 2) {
-                    x = x - 1;
-                    hmoved = 1;
-                    hinverted = 1;
-                }
-            }
-            // Down Movement
-            if ((GPIOA->IDR & (1 << 11)) == 0) {
-                if (y < 144) {
-                    y = y + 1;
-                    vmoved = 1;
-                    vinverted = 0;
-                }
-            }
-            // Up Movement
-            if ((GPIOA->IDR & (1 << 8)) == 0) {
-                if (y > 1) {
-                    y = y - 1;
-                    vmoved = 1;
-                    vinverted = 1;
-                }
-            }
-        }
-
-        /*** Update Player Position ***/
-        if (vmoved || hmoved) {
-            fillRectangle(oldx, oldy, 12, 16, 0);  // Clear old position
-            oldx = x;
-            oldy = y;
-
-            // Draw player with appropriate sprite
-            if (hmoved) {
-                // Horizontal movement animation
-                putImage(x, y, 12, 16, toggle ? pac1 : pacman2, hinverted, 0);
-                toggle ^= 1;  // Switch animation frame
-            } else {
-                // Vertical movement sprite
-                putImage(x, y, 12, 16, pacman3top, 0, vinverted);
-            }
-
-            /*** Heart Collection Checks ***/
-            // Heart 1 Collection
-            if (!heart1_eaten && isInside(heart1_x, heart1_y, 12, 16, x, y)) {
-                printTextX2("Mahal Kita", 7, 20, RGBToWord(0xff, 0xff, 0), 0);
-                fillRectangle(heart1_x, heart1_y, 12, 16, 0);
-                heart1_eaten = 1;
-                
-                // Play collection sound
-                playNote(500);
-                delay(500);
-                playNote(0);
-                
-                GPIOA->ODR |= (1 << 0);  // Turn on red LED
-                eputs("Pacman eats the heart 1\r\n");
-                checkWinCondition(x, y);
-            }
-
-            // Heart 2 Collection
-            if (!heart2_eaten && isInside(heart2_x, heart2_y, 12, 16, x, y)) {
-                printTextX2("Mama", 7, 40, RGBToWord(0xff, 0xff, 0), 0);
-                fillRectangle(heart2_x, heart2_y, 12, 16, 0);
-                heart2_eaten = 1;
-                
-                // Play collection sound
-                playNote(500);
-                delay(500);
-                playNote(0);
-                
-                eputs("Pacman eats the heart 2\r\n");
-                checkWinCondition(x, y);
-            }
-        }
-
-
-
-/******************************************************************************
- * Heart Movement and Collision System
- *****************************************************************************/
-        // Update hearts every 400ms if game is active
-        if (milliseconds - heart_move_delay >= 400 && !game_over) {
-            
-            /*** Heart 1 Movement ***/
-            if (!heart1_eaten) {
-                // Remove heart from old position
-                fillRectangle(heart1_x, heart1_y, 12, 16, 0);
-
-                // Calculate random movement direction
-                heart1_direction_x = (rand() % 3) - 1;  // -1, 0, or 1
-                heart1_direction_y = (rand() % 3) - 1;
-                
-                // Move heart by 3 pixels in chosen direction
-                heart1_x += 3 * heart1_direction_x;
-                heart1_y += 3 * heart1_direction_y;
-
-                // Keep heart within screen boundaries
-                if (heart1_x <= 0) heart1_x = 0;
-                if (heart1_x >= 115) heart1_x = 115;
-                if (heart1_y <= 0) heart1_y = 0;
-                if (heart1_y >= 144) heart1_y = 144;
-
-                // Draw heart in new position
-                putImage(heart1_x, heart1_y, 12, 16, pacmanheart, 0, 0);
-            }
-
-            /*** Heart 2 Movement ***/
-            if (!heart2_eaten) {
-                // Similar movement pattern as heart 1
-                fillRectangle(heart2_x, heart2_y, 12, 16, 0);
-                heart2_direction_x = (rand() % 3) - 1;
-                heart2_direction_y = (rand() % 3) - 1;
-                heart2_x += 3 * heart2_direction_x;
-                heart2_y += 3 * heart2_direction_y;
-
-                // Boundary checks
-                if (heart2_x <= 0) heart2_x = 0;
-                if (heart2_x >= 115) heart2_x = 115;
-                if (heart2_y <= 0) heart2_y = 0;
-                if (heart2_y >= 144) heart2_y = 144;
-
-                putImage(heart2_x, heart2_y, 12, 16, pacmanheart2, 0, 0);
-            }
-
-            /*** Level 2 Additional Hearts ***/
-            if (current_level == 2) {
-                // Heart 3 Movement
-                if (!heart3_eaten) {
-                    fillRectangle(heart3_x, heart3_y, 12, 16, 0);
-                    heart3_direction_x = (rand() % 3) - 1;
-                    heart3_direction_y = (rand() % 3) - 1;
-                    heart3_x += 3 * heart3_direction_x;
-                    heart3_y += 3 * heart3_direction_y;
-                    
-                    // Boundary checks
-                    if (heart3_x <= 0) heart3_x = 0;
-                    if (heart3_x >= 115) heart3_x = 115;
-                    if (heart3_y <= 0) heart3_y = 0;
-                    if (heart3_y >= 144) heart3_y = 144;
-                    
-                    putImage(heart3_x, heart3_y, 12, 16, pacmanheart, 0, 0);
-                }
-
-                // Heart 4 Movement
-                if (!heart4_eaten) {
-                    // Similar pattern as other hearts
-                    fillRectangle(heart4_x, heart4_y, 12, 16, 0);
-                    heart4_direction_x = (rand() % 3) - 1;
-                    heart4_direction_y = (rand() % 3) - 1;
-                    heart4_x += 3 * heart4_direction_x;
-                    heart4_y += 3 * heart4_direction_y;
-                    
-                    // Boundary checks
-                    if (heart4_x <= 0) heart4_x = 0;
-                    if (heart4_x >= 115) heart4_x = 115;
-                    if (heart4_y <= 0) heart4_y = 0;
-                    if (heart4_y >= 144) heart4_y = 144;
-                    
-                    putImage(heart4_x, heart4_y, 12, 16, pacmanheart, 0, 0);
-                }
-            }
-
-            /*** Enemy Collision Check ***/
-            if(!game_won && checkEnemyCollision(x, y)) {
-                game_over = 1;  // Game ends if player hits enemy
-                
-                // Clear entire screen
-                fillRectangle(0, 0, 128, 160, 0);
-
-                // Remove all active enemies
-                for(int i = 0; i < MAX_ENEMIES; i++) {
-                    if(enemies[i].active) {
-                        fillRectangle(enemies[i].x, enemies[i].y, 12, 16, 0);
-                        enemies[i].active = 0;
-                    }
-                }
-
-                // Clear remaining hearts
-                fillRectangle(heart1_x, heart1_y, 12, 16, 0);
-                fillRectangle(heart2_x, heart2_y, 12, 16, 0);
-
-                // Remove player sprite
-                fillRectangle(x, y, 12, 16, 0);
-
-                // Show game over menu
-                show_game_over_menu = 1;
-                game_over_selection = 0;
-                drawGameOverMenu();
-            }
-
-            // Reset movement timer
-            heart_move_delay = milliseconds;
-        }
-        /******************************************************************************
-         * Level 2 Heart Collection Logic
-         *****************************************************************************/
-        if (current_level == 2) {
-            // Check collision with Heart 3
-            if (!heart3_eaten && isInside(heart3_x, heart3_y, 12, 16, x, y)) {
-                printTextX2("Heart 3!", 7, 60, RGBToWord(0xff, 0xff, 0), 0);  // Show collection message
-                fillRectangle(heart3_x, heart3_y, 12, 16, 0);                 // Remove heart from screen
-                heart3_eaten = 1;                                             // Mark as collected
-                
-                // Play collection sound effect
-                playNote(500);
-                delay(500);
-                playNote(0);
-                
-                eputs("Pacman eats heart 3\r\n");                            // Log to serial
-                checkWinCondition(x, y);                                     // Check if level complete
-            }
-
-            // Check collision with Heart 4 (same pattern as Heart 3)
-            if (!heart4_eaten && isInside(heart4_x, heart4_y, 12, 16, x, y)) {
-                printTextX2("Heart 4!", 7, 80, RGBToWord(0xff, 0xff, 0), 0);
-                fillRectangle(heart4_x, heart4_y, 12, 16, 0);
-                heart4_eaten = 1;
-                
-                playNote(500);
-                delay(500);
-                playNote(0);
-                
-                eputs("Pacman eats heart 4\r\n");
-                checkWinCondition(x, y);
-            }
-        }
-
-        /******************************************************************************
-         * Game Over/Win Menu Navigation
-         *****************************************************************************/
-        if (game_over || game_won) {
-            // Handle menu navigation with up/down buttons
-            if ((GPIOA->IDR & (1 << 11)) == 0) {  // Down pressed
-                delay(200);                        // Debounce delay
-                game_over_selection = !game_over_selection;  // Toggle selection
-                drawGameOverMenu();                // Redraw menu
-            }
-            if ((GPIOA->IDR & (1 << 8)) == 0) {   // Up pressed
-                delay(200);
-                game_over_selection = !game_over_selection;
-                drawGameOverMenu();
-            }
-
-            // Handle selection confirmation
-            if ((GPIOB->IDR & (1 << 4)) == 0) {   // Right/Enter pressed
-                delay(200);
-                
-                if (game_over_selection == 0) {    // "Play Again" selected
-                    // Reset game state to level 1
-                    current_level = 1;
-                    game_over = 0;
-                    game_won = 0;
-                    heart1_eaten = 0;
-                    heart2_eaten = 0;
-                    heart3_eaten = 0;
-                    heart4_eaten = 0;
-                    show_game_over_menu = 0;
-                    
-                    // Reset player and heart positions
-                    x = 50;
-                    y = 50;
-                    oldx = x;
-                    oldy = y;
-                    heart1_x = 40;
-                    heart1_y = 80;
-                    heart2_x = 60;
-                    heart2_y = 90;
-                    
-                    // Reset game display
-                    fillRectangle(0, 0, 128, 160, 0);    // Clear screen
-                    drawBackground();                     // Draw maze
-                    initEnemies();                       // Reset enemies
-                    // Draw initial hearts
-                    putImage(heart1_x, heart1_y, 12, 16, pacmanheart, 0, 0);
-                    putImage(heart2_x, heart2_y, 12, 16, pacmanheart2, 0, 0);
-                    
-                } else {  // "Main Menu" selected
-                    in_menu = 1;                         // Return to main menu
-                    show_game_over_menu = 0;             // Hide game over menu
-                    current_level = 1;                   // Reset to level 1
-                }
-            }
-        }
-
-        delay(20);  // Control game speed
-    }
-
-    return 0;  // End of main function
-}
-
-
-void initSysTick(void)
-{
-	SysTick->LOAD = 48000;
-	SysTick->CTRL = 7;
-	SysTick->VAL = 10;
-	__asm(" cpsie i "); // enable interrupts
-}
-void SysTick_Handler(void)
-{
-	milliseconds++;
-    static int index = 0;
-    static int current_note_timer;
-    //Background tune handler
-    if (background_tune_notes !=0)
-    {
-        //if there is no tune
-        if (current_note_timer == 0)
-        {
-            //. move on to the next note (if there is none)
-            index ++;
-            if (index >= background_tune_note_count)
-            {
-                // no more notes
-                if (background_repeat_tune == 0)
-                {
-                    //dont repeat
-                    background_tune_notes = 0;
-                }
-                else
-                {
-                    index = 0; //reset to first note and repeat
-                }
-            }
-            else
-            {
-                current_note_timer = background_tune_times[index];
-                playNote(background_tune_notes[index]);
-            }
-        }
-        if(current_note_timer != 0)
-        {
-            current_note_timer --;
-        }
-
-
-    }
-}
-void initClock(void)
-{
-// This is potentially a dangerous function as it could
-// result in a system with an invalid clock signal - result: a stuck system
-        // Set the PLL up
-        // First ensure PLL is disabled
-        RCC->CR &= ~(1u<<24);
-        while( (RCC->CR & (1 <<25))); // wait for PLL ready to be cleared
-        
-// Warning here: if system clock is greater than 24MHz then wait-state(s) need to be
-// inserted into Flash memory interface
-				
-        FLASH->ACR |= (1 << 0);
-        FLASH->ACR &=~((1u << 2) | (1u<<1));
-        // Turn on FLASH prefetch buffer
-        FLASH->ACR |= (1 << 4);
-        // set PLL multiplier to 12 (yielding 48MHz)
-        RCC->CFGR &= ~((1u<<21) | (1u<<20) | (1u<<19) | (1u<<18));
-        RCC->CFGR |= ((1<<21) | (1<<19) ); 
-
-        // Need to limit ADC clock to below 14MHz so will change ADC prescaler to 4
-        RCC->CFGR |= (1<<14);
-
-        // and turn the PLL back on again
-        RCC->CR |= (1<<24);        
-        // set PLL as system clock source 
-        RCC->CFGR |= (1<<1);
-}
-void delay(volatile uint32_t dly)
-{
-	uint32_t end_time = dly + milliseconds;
-	while(milliseconds != end_time)
-		__asm(" wfi "); // sleep
-}
-
-void enablePullUp(GPIO_TypeDef *Port, uint32_t BitNumber)
-{
-	Port->PUPDR = Port->PUPDR &~(3u << BitNumber*2); // clear pull-up resistor bits
-	Port->PUPDR = Port->PUPDR | (1u << BitNumber*2); // set pull-up bit
-}
-void pinMode(GPIO_TypeDef *Port, uint32_t BitNumber, uint32_t Mode)
-{
-	/*
-	*/
-	uint32_t mode_value = Port->MODER;
-	Mode = Mode << (2 * BitNumber);
-	mode_value = mode_value & ~(3u << (BitNumber * 2));
-	mode_value = mode_value | Mode;
-	Port->MODER = mode_value;
-}
-int isInside(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h, uint16_t px, uint16_t py)
-{
-	// checks to see if point px,py is within the rectange defined by x,y,w,h
-	uint16_t x2,y2;
-	x2 = x1+w;
-	y2 = y1+h;
-	int rvalue = 0;
-	if ( (px >= x1) && (px <= x2))
-	{
-		// ok, x constraint met
-		if ( (py >= y1) && (py <= y2))
-			rvalue = 1;
-	}
-	return rvalue;
-}
-
-void setupIO()
-{
-	RCC->AHBENR |= (1 << 18) + (1 << 17); // enable Ports A and B
-	display_begin();
-	pinMode(GPIOB,4,0);
-	pinMode(GPIOB,5,0);
-	pinMode(GPIOA,8,0);
-	pinMode(GPIOA,11,0);
-    pinMode(GPIOA,12,0);//for the red led cant get it working
-	enablePullUp(GPIOB,4);
-	enablePullUp(GPIOB,5);
-	enablePullUp(GPIOA,11);
-	enablePullUp(GPIOA,8);
-}
-
-
-
-
-
-
-
-
-
-
-
-
+/******************************************************************************
+ * Heart Chaser - Embedded Systems Game
+ ******************************************************************************
+ * File:    main.c
+ * Course:  TU857-2 Microprocessor Systems
+ * School:  Technological University Dublin
+ * Term:    Semester 1, 2024-25
+ * 
+ * Authors: Vengie Legaspi
+ *          Cristian [Last Name]
+ *          John [Last Name]
+ *
+ * Date:    November 6, 2024
+ * 
+ * Description:
+ *     A maze-based game where the player chases and collects hearts while
+ *     avoiding enemy pumpkins. Features multiple levels, sound effects,
+ *     and animated sprites. Developed for STM32F031 microcontroller.
+ * 
+ * Hardware:
+ *     - STM32F031 MCU
+ *     - LCD Display
+ *     - 4 Directional Buttons
+ *     - Speaker for Sound Effects
+ *****************************************************************************/
+
+/******************************************************************************
+ * Include Files
+ *****************************************************************************/
+#include <string.h>       // Required for string operations (strlen for text centering)
+#include <stm32f031x6.h>  // STM32 microcontroller specific definitions
+#include "display.h"      // LCD display functions
+#include <stdlib.h>       // Required for random number generation (heart movement)
+#include "sound.h"        // Sound effect functions for eating hearts
+#include "musical_notes.h"// Musical note definitions for sound effects
+#include "serial.h"       // Serial communication functions
+#include "tiles.h"        // Tile map renderer for the maze playfield
+#include "hud.h"          // Score and timer fields under the playfield
+#include "fade.h"         // Colour fades for the victory screen
+#include "transition.h"   // Wipes, blinds and dissolves between screens
+#include <stdio.h>        // Standard I/O (sprintf for text formatting)
+
+/******************************************************************************
+ * Function Prototypes
+ *****************************************************************************/
+// Core game rendering functions
+void drawBackground(void);        // Draws the maze and background
+void selectMaze(void);            // Hands the current level's maze to the tile renderer
+void drawHud(void);               // Draws the HUD labels under the maze
+void drawHudArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);      // Draws part of the HUD line
+void showHudMessage(const char *text);  // Shows a message in the HUD line for a while
+void startGameScreen(uint8_t type);  // Brings the maze in with a screen transition
+void drawGameArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);     // Draws part of the maze and HUD
+void drawLevelBanner(uint16_t x, uint16_t y, uint16_t w, uint16_t h);  // Draws part of the level 2 banner
+void updateSprites(uint16_t pacman_x, uint16_t pacman_y, const PalImage *pacman_frame,
+                   int hflip, int vflip, int transpose);  // Moves the renderer's sprites to match the game
+void showWinScreen(void);         // Displays the victory screen
+void initEnemies(void);           // Sets up enemy positions and properties
+void checkWinCondition(uint16_t x, uint16_t y);  // Checks if level is complete
+void moveEnemies(uint16_t pacman_x, uint16_t pacman_y);  // Updates enemy positions
+int checkEnemyCollision(uint16_t pacman_x, uint16_t pacman_y);  // Detects player-enemy collisions
+
+// Menu and UI functions
+void drawGameOverMenu(void);      // Shows game over screen
+void drawMenu(void);              // Displays main menu
+void showControls(void);          // Shows game controls
+void showCredits(void);           // Displays game credits
+int screenPowerPolicy(void);      // Lowers panel power on screens left alone
+
+/******************************************************************************
+ * Game Constants
+ *****************************************************************************/
+// Game configuration
+#define MAX_ENEMIES 6    // Number of pumpkin enemies (increased from 3 to 6)
+#define MAX_HEARTS 6     // Maximum number of collectible hearts in final level
+
+// Maze appearance constants
+#define WALL_COLOR RGB565(0, 0, 255)     // Blue color for maze walls
+#define PATH_COLOR RGB565(0, 0, 20)      // Dark background color for paths
+#define WALL_SIZE 8                      // Size of each wall block in pixels
+#define LEVEL1_ROWS 20                   // Maze heights in walls; level 2 is taller
+#define LEVEL2_ROWS 30                   // than the screen and scrolls
+#define MAZE_HEIGHT (((current_level == 1) ? LEVEL1_ROWS : LEVEL2_ROWS) * WALL_SIZE)
+#define MAX_X (SCREEN_WIDTH - 1 - 12)    // Right-most position for a 12 pixel wide sprite
+#define MAX_Y (MAZE_HEIGHT - 16)         // Lowest position for a 16 pixel tall sprite
+#define PACMAN_WIDTH 12                  // Player facing left or right; turned up or down
+#define PACMAN_HEIGHT 16                 // it is PACMAN_HEIGHT wide and PACMAN_WIDTH high
+
+// Tile renderer sprite slots, drawn in this order (later ones on top)
+#define SLOT_HEART 0                     // Hearts 1-4 use slots 0-3
+#define SLOT_ENEMY 4                     // Enemies use slots 4-9
+#define SLOT_BOSS 10
+#define SLOT_PACMAN 11
+
+// Heads up display, in the fixed lines under the scrolling playfield
+#define HUD_Y (TILE_ROWS * TILE_SIZE)
+#define HUD_COLOR RGB565(0xff, 0xff, 0)
+#define HUD_MESSAGE_MS 2000             // How long a heart message replaces the HUD
+
+// How long the level 2 banner stays up before the maze comes in
+#define LEVEL_BANNER_MS 1000
+
+// Victory screen colors
+#define WIN_GOLD RGB565(0xFF, 0xD7, 0x00)     // Golden color for victory effects
+#define WIN_PINK RGB565(0xFF, 0x69, 0xB4)     // Pink color for victory effects
+#define WIN_BLUE RGB565(0x00, 0xBF, 0xFF)     // Sky blue for victory effects
+
+// Menu color scheme
+#define TITLE_COLOR RGB565(0xff, 0x1a, 0x1a)     // Bright red for titles
+#define SELECTED_COLOR RGB565(0xff, 0xff, 0)      // Yellow for selected items
+#define UNSELECTED_COLOR RGB565(0, 0xff, 0)       // Green for unselected items
+#define BORDER_COLOR RGB565(0, 0, 0xff)           // Blue for borders
+
+/******************************************************************************
+ * Sound Variables
+ *****************************************************************************/
+// Background music variables
+const uint32_t *background_tune_notes;    // Pointer to background music notes
+const uint32_t *background_tune_times;    // Pointer to note durations
+uint32_t background_tune_note_count;      // Number of notes in background music
+uint32_t background_repeat_tune;          // Flag to loop background music
+uint32_t pumpkin_move_delay = 0;         // Timer for enemy movement
+
+// Sound effect variables
+const uint32_t my_notes[] = {A3,C5,B2,D1,F6};  // Notes for sound effects
+const uint32_t my_note_times[] = {200,300,400,100,500};  // Duration of each note
+uint32_t repeat_tune;  // Flag to repeat sound effect
+
+/******************************************************************************
+ * Game State Variables
+ *****************************************************************************/
+// Core game state
+int game_won = 0;              // Tracks if player has won
+int game_over = 0;             // Tracks if game is over
+int show_game_over_menu = 0;   // Controls game over menu visibility
+int game_over_selection = 0;   // Menu selection (0=Play Again, 1=Main Menu)
+
+// Panel power saving on screens that only change on input
+#define IDLE_AFTER_MS 10000    // Drop to the 8 colour idle mode after this long without input
+#define SLEEP_AFTER_MS 60000   // Turn the panel off after this long
+uint32_t last_input_time = 0;  // When a button was last pressed (or a static screen shown)
+int panel_saving = 0;          // Panel is in idle mode or asleep
+
+/******************************************************************************
+ * System Function Prototypes
+ *****************************************************************************/
+void initClock(void);          // Initialize system clock
+void initSysTick(void);        // Initialize system timer
+uint32_t readCycles(void);     // CPU cycle count for timing code
+void SysTick_Handler(void);    // System tick interrupt handler
+void delay(volatile uint32_t dly);  // Time delay function
+void setupIO();                // Initialize IO pins
+int isInside(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h, 
+             uint16_t px, uint16_t py);  // Collision detection
+void enablePullUp(GPIO_TypeDef *Port, uint32_t BitNumber);  // GPIO pull-up config
+void pinMode(GPIO_TypeDef *Port, uint32_t BitNumber, uint32_t Mode);  // GPIO mode config
+
+/******************************************************************************
+ * Game Object Variables
+ *****************************************************************************/
+// System timing
+volatile uint32_t milliseconds;  // System time counter
+
+// Heart positions and states - Level 1
+uint16_t heart1_x = 40, heart1_y = 80;  // Heart 1 position
+uint16_t heart2_x = 60, heart2_y = 90;  // Heart 2 position
+int heart1_direction_x = 1;             // Heart 1 movement direction
+int heart1_direction_y = 1;
+int heart2_direction_x = 1;             // Heart 2 movement direction
+int heart2_direction_y = 1;
+uint32_t heart_move_delay = 0;          // Heart movement timer
+int heart1_eaten = 0;                   // Heart collection status
+int heart2_eaten = 0;
+
+// Level tracking
+int current_level = 1;         // Current game level (now goes to 3)
+int hearts_collected = 0;      // Total hearts collected
+uint16_t game_seconds = 0;     // Time since the game started, shown on the HUD
+uint32_t game_second_mark = 0; // milliseconds at the start of the current second
+HudNumber hud_hearts, hud_time;
+const Layer hud_labels[] = {
+    {LAYER_TEXT, 1, 2, HUD_Y, 0, 0, HUD_COLOR, "HEARTS"},
+    {LAYER_TEXT, 1, 70, HUD_Y, 0, 0, HUD_COLOR, "TIME"},
+};
+const char *hud_message = 0;   // Shown in place of the HUD labels, 0 for none
+uint32_t hud_message_time = 0; // milliseconds when it went up
+int level_banner = 0;          // The level 2 banner is coming in; the maze follows it
+
+// Heart positions and states - Level 2 & 3
+uint16_t heart3_x = 80, heart3_y = 70;  // Heart 3 position
+uint16_t heart4_x = 30, heart4_y = 200; // Heart 4 position (below the first screen)
+uint16_t heart5_x = 90, heart5_y = 110; // Heart 5 position (new)
+uint16_t heart6_x = 20, heart6_y = 60;  // Heart 6 position (new)
+int heart3_eaten = 0;                   // Heart collection status
+int heart4_eaten = 0;
+int heart5_eaten = 0;                   // New heart status
+int heart6_eaten = 0;                   // New heart status
+int heart3_direction_x = 1, heart3_direction_y = 1;  // Movement directions
+int heart4_direction_x = 1, heart4_direction_y = 1;
+int heart5_direction_x = 1, heart5_direction_y = 1;  // New heart movement
+int heart6_direction_x = 1, heart6_direction_y = 1;  // New heart movement
+
+// Boss enemy variables (new)
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    int active;
+    int speed;
+    int size;  // Boss is larger than regular enemies
+} Boss;
+
+Boss boss = {64, 80, 0, 2, 24};  // Boss initialization
+#define BOSS_SCALE 2                 // The boss is the pumpkin sprite drawn at twice the size
+#define BOSS_HEIGHT (16 * BOSS_SCALE)
+#define BOSS_MAX_Y (MAZE_HEIGHT - BOSS_HEIGHT)  // Lowest position for the boss
+
+/******************************************************************************
+ * Sprite Definitions
+ *****************************************************************************/
+// Sprites are 12x16, 4 bits per pixel with index 0 as the transparent colour
+// (see PalImage in display.h).  The Pacman and heart sprites are generated from
+// the bmp files with assets/bmptopal.py.
+
+// Pacman sprites facing right (open, closed), turned to face the other ways as they are drawn
+const uint16_t pacman_palette[] = {0,24327,24576,40871,37916,30733,44867,31254,38693,54324,4644,30229,28459,37180,46381,65535};
+const uint8_t pac1_pixels[] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x20,0x00,0x00,0x00,
+	0x00,0x00,0x68,0x66,0xd0,0x00,
+	0x00,0xd7,0x11,0x11,0x61,0x20,
+	0x00,0xe1,0x1f,0x11,0x77,0xd0,
+	0x28,0x16,0x11,0x33,0x33,0x30,
+	0x09,0xae,0x13,0x00,0x00,0x00,
+	0x29,0x89,0xd1,0x33,0x33,0x30,
+	0x00,0x68,0x81,0x11,0x11,0x70,
+	0x00,0xd6,0x79,0xe7,0x87,0x20,
+	0x00,0x00,0x99,0xd6,0x62,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+};
+const PalImage pac1 = {12, 16, pacman_palette, pac1_pixels};
+const uint8_t pacman2_pixels[] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x22,0x22,0x20,0x00,
+	0x00,0x00,0x6e,0x87,0xe0,0x00,
+	0x00,0x17,0x11,0x11,0x77,0x80,
+	0x00,0xe1,0x1f,0x11,0x13,0x30,
+	0x2e,0x16,0x11,0x13,0x30,0x00,
+	0x09,0xae,0x13,0x30,0x00,0x00,
+	0x29,0x89,0xd1,0x13,0x30,0x00,
+	0x00,0x68,0x87,0xd1,0x13,0x30,
+	0x00,0x16,0x79,0xe7,0x87,0x82,
+	0x00,0x00,0x99,0xd6,0x60,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+};
+const PalImage pacman2 = {12, 16, pacman_palette, pacman2_pixels};
+
+// Heart sprites
+const uint16_t heart_palette[] = {0,23568,6945,39952,23081,14906,64049,48144,39960,31529,14898,31768};
+const uint8_t pacmanheart_pixels[] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x01,0x10,0x01,0x10,0x00,
+	0x00,0x11,0x10,0x01,0x11,0x00,
+	0x03,0x42,0x11,0x11,0x11,0x10,
+	0x01,0x25,0x67,0x11,0x11,0x10,
+	0x01,0x89,0xa1,0x11,0x11,0x10,
+	0x01,0x11,0xb1,0x11,0x11,0x10,
+	0x00,0x11,0x11,0x11,0x11,0x00,
+	0x00,0x01,0x11,0x11,0x10,0x00,
+	0x00,0x00,0x01,0x10,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+};
+const PalImage pacmanheart = {12, 16, heart_palette, pacmanheart_pixels};
+const uint8_t pacmanheart2_pixels[] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x01,0x10,0x01,0x10,0x00,
+	0x00,0x11,0x10,0x01,0x11,0x00,
+	0x03,0x42,0x11,0x11,0x11,0x10,
+	0x01,0x25,0x67,0x11,0x11,0x10,
+	0x01,0x89,0xa1,0x11,0x11,0x10,
+	0x01,0x11,0xb1,0x11,0x11,0x10,
+	0x00,0x11,0x11,0x11,0x11,0x00,
+	0x00,0x01,0x11,0x11,0x10,0x00,
+	0x00,0x00,0x01,0x10,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,
+};
+const PalImage pacmanheart2 = {12, 16, heart_palette, pacmanheart2_pixels};
+
+// Pumpkin sprite - a scary 12x16 jack-o'-lantern (green stem, evil eyes and grin)
+const uint16_t pumpkin_palette[] = {0,64800,65535,2016};
+const uint8_t pumpkin_sprite_pixels[] = {
+	0x00,0x00,0x33,0x33,0x00,0x00,
+	0x00,0x33,0x33,0x33,0x33,0x00,
+	0x01,0x13,0x33,0x33,0x31,0x10,
+	0x11,0x11,0x11,0x11,0x11,0x11,
+	0x12,0x12,0x11,0x21,0x21,0x11,
+	0x12,0x12,0x11,0x21,0x21,0x11,
+	0x11,0x11,0x11,0x11,0x11,0x11,
+	0x11,0x11,0x00,0x11,0x11,0x11,
+	0x11,0x10,0x22,0x01,0x11,0x11,
+	0x11,0x02,0x22,0x20,0x11,0x11,
+	0x11,0x22,0x22,0x22,0x11,0x11,
+	0x11,0x20,0x22,0x02,0x11,0x11,
+	0x11,0x00,0x00,0x00,0x11,0x11,
+	0x01,0x11,0x11,0x11,0x11,0x10,
+	0x00,0x11,0x11,0x11,0x11,0x00,
+	0x00,0x01,0x11,0x11,0x10,0x00,
+};
+const PalImage pumpkin_sprite = {12, 16, pumpkin_palette, pumpkin_sprite_pixels};
+
+/******************************************************************************
+ * Enemy Structure Definition
+ *****************************************************************************/
+// Structure to track enemy properties
+typedef struct {
+    uint16_t x;       // X position on screen
+    uint16_t y;       // Y position on screen
+    int active;       // Whether enemy is currently active
+    int speed;        // Movement speed of enemy
+} Enemy;
+Enemy enemies[MAX_ENEMIES];  // Array to hold all enemy instances
+
+
+// Ghost sprite - a cute 12x16 ghost shape
+/*const uint16_t ghost_sprite[] = {
+    0,0,0,0,63488,63488,63488,63488,0,0,0,0,
+    0,0,63488,63488,63488,63488,63488,63488,63488,63488,0,0,
+    0,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,0,
+    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
+    63488,63488,65535,65535,63488,63488,65535,65535,63488,63488,63488,63488,
+    63488,63488,65535,65535,63488,63488,65535,65535,63488,63488,63488,63488,
+    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
+    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
+    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
+    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
+    63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,63488,
+    63488,0,63488,63488,0,63488,63488,0,63488,63488,0,63488,
+    0,0,0,63488,0,0,63488,0,0,63488,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0
+};*/
+
+/******************************************************************************
+ * Enemy Management Functions
+ *****************************************************************************/
+/**
+ * Initializes enemies for each level
+ * Sets initial positions, activation status, and speeds
+ */
+void initEnemies() {
+    if (current_level == 1) {
+        // Level 1: Single enemy setup
+        enemies[0].x = 10;            // Starting X position
+        enemies[0].y = 10;            // Starting Y position
+        enemies[0].active = 1;        // Activate enemy
+        enemies[0].speed = 1;         // Base movement speed
+        boss.active = 0;              // The boss waits for level 2
+    } else {
+        // Level 2: Three enemies with adjusted positions
+        // First enemy
+        enemies[0].x = 10;
+        enemies[0].y = 10;
+        enemies[0].active = 1;
+        enemies[0].speed = 1;
+
+        // Second enemy
+        enemies[1].x = 100;
+        enemies[1].y = 10;
+        enemies[1].active = 1;
+        enemies[1].speed = 1;
+
+        // Third enemy
+        enemies[2].x = 60;
+        enemies[2].y = 140;
+        enemies[2].active = 1;
+        enemies[2].speed = 1;
+
+        // Boss in the middle of the first screen
+        boss.x = 64;
+        boss.y = 80;
+        boss.active = 1;
+    }
+}
+
+/******************************************************************************
+ * Sound Functions
+ *****************************************************************************/
+/**
+ * Plays a sequence of musical notes
+ * @param notes: Array of note frequencies
+ * @param times: Array of note durations
+ * @param len: Length of the arrays
+ */
+void playTune(const uint32_t notes[], const uint32_t times[], int len) {
+    for (int i=0; i<len; i++) {
+        playNote(notes[i]);
+        delay(times[i]);
+    }
+    playNote(0);  // Stop sound
+}
+
+/******************************************************************************
+ * Enemy Movement Functions
+ *****************************************************************************/
+/**
+ * Updates enemy positions relative to player location
+ * @param pacman_x: Player's X coordinate
+ * @param pacman_y: Player's Y coordinate
+ */
+void moveEnemies(uint16_t pacman_x, uint16_t pacman_y) {
+    if (game_won) return;  // Skip if game is won
+
+    // Set movement delay based on level
+    uint32_t delay_time = (current_level == 1) ? 30 : 65;
+    
+    // Control movement timing
+    if (milliseconds - pumpkin_move_delay < delay_time) {
+        return;
+    }
+    pumpkin_move_delay = milliseconds;
+    
+    // Update each enemy's position
+    for(int i = 0; i < MAX_ENEMIES; i++) {
+        if(enemies[i].active) {
+            // Calculate movement speed based on level
+            int current_speed;
+            if (current_level == 2) {
+                // Slower movement in level 2
+                current_speed = (milliseconds % 2 == 0) ? 1 : 0;
+            } else {
+                current_speed = enemies[i].speed;
+            }
+            
+            // Move toward player
+            if(enemies[i].x < pacman_x) enemies[i].x += current_speed;
+            if(enemies[i].x > pacman_x) enemies[i].x -= current_speed;
+            if(enemies[i].y < pacman_y) enemies[i].y += current_speed;
+            if(enemies[i].y > pacman_y) enemies[i].y -= current_speed;
+            
+            // Enforce screen boundaries
+            enemies[i].x = (enemies[i].x <= 0) ? 0 : 
+                          (enemies[i].x >= MAX_X) ? MAX_X : enemies[i].x;
+            enemies[i].y = (enemies[i].y <= 0) ? 0 : 
+                          (enemies[i].y >= MAX_Y) ? MAX_Y : enemies[i].y;
+        }
+    }
+
+    // The boss steers its centre towards the player's, boss.speed at a time on
+    // every other step
+    static int boss_step = 0;
+    boss_step ^= 1;
+    if (boss.active) {
+        int boss_speed = boss_step ? boss.speed : 0;
+        int target_x = pacman_x + 6 - boss.size / 2;
+        int target_y = pacman_y + 8 - BOSS_HEIGHT / 2;
+        int bx = boss.x, by = boss.y;
+
+        if (bx < target_x) bx += boss_speed;
+        if (bx > target_x) bx -= boss_speed;
+        if (by < target_y) by += boss_speed;
+        if (by > target_y) by -= boss_speed;
+
+        // Enforce screen boundaries
+        boss.x = (bx <= 0) ? 0 : (bx >= SCREEN_WIDTH - boss.size) ? SCREEN_WIDTH - boss.size : bx;
+        boss.y = (by <= 0) ? 0 : (by >= BOSS_MAX_Y) ? BOSS_MAX_Y : by;
+    }
+}
+
+/**
+ * Checks for collision between player and enemies
+ * @param pacman_x: Player's X coordinate
+ * @param pacman_y: Player's Y coordinate
+ * @return: 1 if collision detected, 0 otherwise
+ */
+int checkEnemyCollision(uint16_t pacman_x, uint16_t pacman_y) {
+    for(int i = 0; i < MAX_ENEMIES; i++) {
+        if(enemies[i].active && 
+           isInside(enemies[i].x, enemies[i].y, 12, 16, pacman_x, pacman_y)) {
+            return 1;
+        }
+    }
+    if (boss.active && isInside(boss.x, boss.y, boss.size, BOSS_HEIGHT, pacman_x, pacman_y)) {
+        return 1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * Game Logic Functions
+ *****************************************************************************/
+/**
+ * Checks if level/game completion conditions are met
+ * @param x: Player's X coordinate
+ * @param y: Player's Y coordinate
+ */
+void checkWinCondition(uint16_t x, uint16_t y) {
+    // Calculate required hearts based on level
+    int required_hearts = (current_level == 1) ? 2 : 4;
+    hearts_collected = heart1_eaten + heart2_eaten;
+    if (current_level == 2) {
+        hearts_collected += heart3_eaten + heart4_eaten;
+    }
+
+    // Check win conditions
+    if (hearts_collected == required_hearts && !game_won) {
+        if (current_level == 1) {
+            // Advance to level 2
+            current_level = 2;
+            heart1_eaten = heart2_eaten = heart3_eaten = heart4_eaten = 0;
+
+            // Dissolve to the banner and hold it; the main loop then brings
+            // the level 2 maze in.  The game waits until both are complete.
+            display_scrollTo(0);
+            transition_start(TRANSITION_DISSOLVE, drawLevelBanner, LEVEL_BANNER_MS, milliseconds);
+            level_banner = 1;
+            initEnemies();
+            x = 50; y = 50;  // Reset player position
+        } else {
+            // Complete game victory
+            game_won = 1;
+            showWinScreen();
+            last_input_time = milliseconds;
+        }
+    }
+}
+
+/**
+ * Resets heart positions when game ends
+ * @param pacman_x: Player's X coordinate
+ * @param pacman_y: Player's Y coordinate
+ */
+void clearHearts(int pacman_x, int pacman_y) {
+    // Reset hearts not collected by player
+    if (pacman_x != heart1_x || pacman_y != heart1_y) {
+        heart1_x = 40; heart1_y = 80;
+    }
+    if (pacman_x != heart2_x || pacman_y != heart2_y) {
+        heart2_x = 60; heart2_y = 90;
+    }
+}
+
+/******************************************************************************
+ * Maze Definitions and Drawing
+ *****************************************************************************/
+
+// The maze layout (1 = wall, 0 = path)
+const uint8_t maze[LEVEL1_ROWS][16] = {
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
+    {1,0,1,1,1,0,1,0,1,1,1,1,1,1,0,1},
+    {1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,1},
+    {1,1,1,0,1,1,1,1,1,0,1,0,1,1,0,1},
+    {1,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1},
+    {1,0,1,1,1,1,1,0,1,1,1,1,1,0,1,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
+    {1,1,1,1,1,0,1,1,1,1,1,0,1,1,0,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,1,0,0,1},
+    {1,0,1,1,1,1,1,0,1,1,1,1,1,0,1,1},
+    {1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1},
+    {1,0,1,1,1,1,1,1,1,0,1,1,1,1,0,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1},
+    {1,0,1,1,1,1,1,1,1,1,1,1,0,1,0,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
+};
+
+// New maze layout for level 2
+const uint8_t maze_level2[LEVEL2_ROWS][16] = {
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+    {1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,1},
+    {1,0,1,0,1,0,1,1,1,0,1,0,1,1,0,1},
+    {1,0,1,0,0,0,0,0,1,0,0,0,0,1,0,1},
+    {1,0,1,1,1,1,1,0,1,1,1,1,0,1,0,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
+    {1,1,1,1,1,0,1,1,1,0,1,1,1,1,0,1},
+    {1,0,0,0,1,0,0,0,1,0,1,0,0,0,0,1},
+    {1,0,1,0,1,1,1,0,1,0,1,0,1,1,1,1},
+    {1,0,1,0,0,0,0,0,0,0,1,0,0,0,0,1},
+    {1,0,1,1,1,1,1,1,1,1,1,1,1,1,0,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,1},
+    {1,0,1,1,1,0,1,0,1,1,1,1,0,1,0,1},
+    {1,0,0,0,1,0,0,0,1,0,0,0,0,0,0,1},
+    {1,1,1,0,1,1,1,1,1,0,1,1,1,1,0,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,1,1,0,1,1,1,1,1,1,1,0,1,1,1,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
+    {1,0,1,1,1,0,1,0,1,1,1,1,1,1,0,1},
+    {1,0,1,0,0,0,0,0,1,0,0,0,0,1,0,1},
+    {1,0,1,0,1,1,1,1,1,0,1,1,0,1,0,1},
+    {1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,1},
+    {1,1,1,0,1,0,1,1,1,1,1,0,1,1,1,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1},
+    {1,0,1,1,1,1,1,0,1,1,1,1,1,1,0,1},
+    {1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1},
+    {1,0,1,1,1,0,1,1,1,0,1,1,1,1,0,1},
+    {1,0,0,0,1,0,0,0,0,0,0,0,0,1,0,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
+};
+
+
+/******************************************************************************
+ * Background and Maze Drawing Functions
+ *****************************************************************************/
+/**
+ * Draws the game background and maze walls
+ * Handles both level 1 and level 2 maze layouts
+ */
+void drawBackground(void) {
+    selectMaze();
+    tiles_clearSprites();  // Left over from the last game; updateSprites places them again
+    tiles_drawAll();
+    drawHud();
+}
+
+/**
+ * Selects the maze layout for the current level as the tile layer
+ */
+void selectMaze(void) {
+    if (current_level == 1) {
+        tiles_setMap(maze, LEVEL1_ROWS, PATH_COLOR, WALL_COLOR);
+    } else {
+        tiles_setMap(maze_level2, LEVEL2_ROWS, PATH_COLOR, WALL_COLOR);
+    }
+}
+
+/**
+ * Draws the HUD labels; the numbers are drawn by the game loop
+ */
+void drawHud(void) {
+    drawHudArea(0, HUD_Y, SCREEN_WIDTH, SCREEN_HEIGHT - HUD_Y);
+    hud_invalidate(&hud_hearts);
+    hud_invalidate(&hud_time);
+}
+
+/**
+ * Draws one area of the HUD line: the labels, or the current message
+ * centred on a blank line
+ */
+void drawHudArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (hud_message) {
+        Layer message = {LAYER_TEXT, 1, (SCREEN_WIDTH - (strlen(hud_message) * 7 - 2)) / 2, HUD_Y,
+                         0, 0, HUD_COLOR, hud_message};
+        composeArea(x, y, w, h, &message, 1);
+    } else {
+        composeArea(x, y, w, h, hud_labels, 2);
+    }
+}
+
+/**
+ * Shows a message in place of the HUD labels and numbers for HUD_MESSAGE_MS.
+ * The playfield above scrolls, so text drawn there would not stay put.
+ * @param text: Message, at most 18 characters
+ */
+void showHudMessage(const char *text) {
+    hud_message = text;
+    hud_message_time = milliseconds;
+    drawHud();
+}
+
+/**
+ * Replaces the screen with the current level's maze a step at a time; the
+ * sprites and HUD numbers are drawn by the game loop once it is complete
+ * @param type: TRANSITION_WIPE, TRANSITION_BLINDS or TRANSITION_DISSOLVE
+ */
+void startGameScreen(uint8_t type) {
+    selectMaze();
+    tiles_clearSprites();
+    hud_message = 0;
+    hud_invalidate(&hud_hearts);
+    hud_invalidate(&hud_time);
+    transition_start(type, drawGameArea, 0, milliseconds);
+}
+
+/**
+ * Draws one area of the game screen for a transition: the maze above
+ * HUD_Y and the HUD labels below it
+ */
+void drawGameArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (y < HUD_Y) {
+        tiles_drawArea(x, y, w, (y + h > HUD_Y) ? HUD_Y - y : h);
+    }
+    if (y + h > HUD_Y) {
+        uint16_t top = (y > HUD_Y) ? y : HUD_Y;
+        drawHudArea(x, top, w, y + h - top);
+    }
+}
+
+/**
+ * Draws one area of the level 2 banner for a transition
+ */
+void drawLevelBanner(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    static const Layer banner[] = {
+        {LAYER_TEXT, 2, 25, 60, 0, 0, RGB565(0, 0xff, 0), "LEVEL 2!"},
+    };
+    composeArea(x, y, w, h, banner, 1);
+}
+
+/**
+ * Updates the tile renderer's sprite slots from the game state
+ * Called once per frame before tiles_render(); sprites that have not moved
+ * or changed frame are not redrawn
+ * @param pacman_x: Player's X coordinate
+ * @param pacman_y: Player's Y coordinate
+ * @param pacman_frame: Current player sprite
+ * @param hflip: Mirror the player left/right
+ * @param vflip: Mirror the player top/bottom
+ * @param transpose: Turn the player to face down (up with vflip)
+ */
+void updateSprites(uint16_t pacman_x, uint16_t pacman_y, const PalImage *pacman_frame,
+                   int hflip, int vflip, int transpose) {
+    // Hearts (3 and 4 only appear in level 2)
+    if (!heart1_eaten) tiles_moveSprite(SLOT_HEART, heart1_x, heart1_y, &pacmanheart, 0, 0, 0);
+    else tiles_hideSprite(SLOT_HEART);
+    if (!heart2_eaten) tiles_moveSprite(SLOT_HEART + 1, heart2_x, heart2_y, &pacmanheart2, 0, 0, 0);
+    else tiles_hideSprite(SLOT_HEART + 1);
+    if (current_level == 2 && !heart3_eaten) tiles_moveSprite(SLOT_HEART + 2, heart3_x, heart3_y, &pacmanheart, 0, 0, 0);
+    else tiles_hideSprite(SLOT_HEART + 2);
+    if (current_level == 2 && !heart4_eaten) tiles_moveSprite(SLOT_HEART + 3, heart4_x, heart4_y, &pacmanheart, 0, 0, 0);
+    else tiles_hideSprite(SLOT_HEART + 3);
+
+    // Enemies
+    for (int i = 0; i < MAX_ENEMIES; i++) {
+        if (enemies[i].active) {
+            tiles_moveSprite(SLOT_ENEMY + i, enemies[i].x, enemies[i].y, &pumpkin_sprite, 0, 0, 0);
+        } else {
+            tiles_hideSprite(SLOT_ENEMY + i);
+        }
+    }
+
+    // Boss, streamed from the 12x16 pumpkin at BOSS_SCALE times its size
+    if (boss.active) {
+        tiles_moveSpriteScaled(SLOT_BOSS, boss.x, boss.y, &pumpkin_sprite, BOSS_SCALE);
+    } else {
+        tiles_hideSprite(SLOT_BOSS);
+    }
+
+    // Player on top
+    tiles_moveSprite(SLOT_PACMAN, pacman_x, pacman_y, pacman_frame, hflip, vflip, transpose);
+}
+
+/**
+ * Checks if a given position collides with maze walls
+ * @param x: X coordinate to check
+ * @param y: Y coordinate to check
+ * @return: 1 if collision detected, 0 if path is clear
+ */
+int isWallCollision(uint16_t x, uint16_t y) {
+    // Convert pixel coordinates to maze grid coordinates
+    int gridX = x / WALL_SIZE;
+    int gridY = y / WALL_SIZE;
+    
+    // Check if position is within maze bounds
+    if(gridX >= 0 && gridX < 16 && gridY >= 0 && gridY < 20) {
+        return maze[gridY][gridX] == 1;
+    }
+    return 1;  // Treat out-of-bounds as wall collision
+}
+
+/******************************************************************************
+ * Menu System Variables and Functions
+ *****************************************************************************/
+// Menu state tracking
+int in_menu = 1;           // Start in menu state
+int selected_option = 0;   // Currently selected menu option
+#define NUM_MENU_OPTIONS 3 // Total number of menu options
+
+/**
+ * Power policy for static screens: the longer nothing is pressed the less the
+ * panel does.  Called while a menu screen waits for input.
+ * @return: 1 if a press is waking the screen or just woke it; that press should be ignored
+ */
+int screenPowerPolicy(void) {
+    int pressed = ((GPIOB->IDR & ((1 << 4) | (1 << 5))) != ((1 << 4) | (1 << 5))) ||
+                  ((GPIOA->IDR & ((1 << 8) | (1 << 11))) != ((1 << 8) | (1 << 11)));
+    static int waking = 0;  // A press is waking the panel, or is still held after it
+    if (pressed) {
+        last_input_time = milliseconds;
+        if (panel_saving) {
+            waking = 1;
+        }
+    }
+    if (waking && panel_saving) {
+        // Back to full colour; the picture is still in frame memory.  Sleep out
+        // takes a while, so this carries on over the next calls.
+        if (!display_wake(milliseconds)) {
+            return 1;
+        }
+        display_setIdle(0);
+        panel_saving = 0;
+    }
+    if (pressed) {
+        return waking;
+    }
+    waking = 0;
+    if (milliseconds - last_input_time >= SLEEP_AFTER_MS) {
+        display_sleep(milliseconds);
+        panel_saving = 1;
+    } else if (milliseconds - last_input_time >= IDLE_AFTER_MS) {
+        display_setIdle(1);
+        panel_saving = 1;
+    }
+    return 0;
+}
+
+/**
+ * Draws main menu screen with animated elements
+ * The whole screen is composed from layers and sent once
+ */
+void drawMenu() {
+    display_scrollTo(0);  // Full screen pages are drawn unscrolled
+    Layer layers[16];
+    int n = 0;
+
+    // Gradient background: blue rising over 64 rows, repeated down the screen
+    uint16_t ramp[64];
+    makeGradient(ramp, 64, 0, 0, 0, 0, 0, 32);
+    layers[n++] = (Layer){LAYER_PATTERN, 64, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, ramp};
+    layers[n++] = (Layer){LAYER_FRAME, 0, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, BORDER_COLOR, 0};  // Border
+    
+    // Add decorative hearts in corners
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 5, 5, 0, 0, 0, &pacmanheart};      // Top-left
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 111, 5, 0, 0, 0, &pacmanheart};    // Top-right
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 5, 139, 0, 0, 0, &pacmanheart};    // Bottom-left
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 111, 139, 0, 0, 0, &pacmanheart};  // Bottom-right
+    
+    // Title with shadow effect
+    layers[n++] = (Layer){LAYER_TEXT, 2, 36, 21, 0, 0, 0, "HEART"};            // Shadow
+    layers[n++] = (Layer){LAYER_TEXT, 2, 35, 20, 0, 0, TITLE_COLOR, "HEART"};  // Main text
+    layers[n++] = (Layer){LAYER_TEXT, 2, 36, 41, 0, 0, 0, "CHASE"};            // Shadow
+    layers[n++] = (Layer){LAYER_TEXT, 2, 35, 40, 0, 0, TITLE_COLOR, "CHASE"};  // Main text
+    
+    // Separator line
+    layers[n++] = (Layer){LAYER_FILL, 0, 20, 65, 88, 1, BORDER_COLOR, 0};
+    
+    // Menu options with animation
+    static const char* options[] = {"Start Game", "Controls", "Credits"};
+    static int animation_offset = 0;
+    animation_offset = (animation_offset + 1) % 4;
+    
+    // Animated selection box behind the current option
+    int box_x = 35 - animation_offset;
+    int box_width = 60 + (animation_offset * 2);
+    layers[n++] = (Layer){LAYER_FILL, 0, box_x, 78 + (selected_option * 20), box_width, 12,
+                          RGB565(0, 0, 32), 0};
+    
+    // Each menu option
+    for(int i = 0; i < NUM_MENU_OPTIONS; i++) {
+        uint16_t color = (i == selected_option) ? SELECTED_COLOR : UNSELECTED_COLOR;
+        layers[n++] = (Layer){LAYER_TEXT, 1, 40, 80 + (i * 20), 0, 0, color, options[i]};
+    }
+    
+    // Animated Pacman indicator
+    static int pac_toggle = 0;
+    pac_toggle ^= 1;
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 20, 78 + (selected_option * 20), 0, 0, 0,
+                          pac_toggle ? &pac1 : &pacman2};
+
+    composeArea(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, layers, n);
+}
+
+/**
+ * Displays game controls screen
+ */
+void showControls() {
+    Layer layers[12];
+    int n = 0;
+    layers[n++] = (Layer){LAYER_FRAME, 0, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, BORDER_COLOR, 0};  // Border
+    
+    // Title with shadow
+    layers[n++] = (Layer){LAYER_TEXT, 2, 21, 21, 0, 0, 0, "CONTROLS"};            // Shadow
+    layers[n++] = (Layer){LAYER_TEXT, 2, 20, 20, 0, 0, TITLE_COLOR, "CONTROLS"};  // Main text
+    
+    // Separator lines
+    layers[n++] = (Layer){LAYER_FILL, 0, 20, 35, 88, 1, BORDER_COLOR, 0};
+    layers[n++] = (Layer){LAYER_FILL, 0, 20, 120, 88, 1, BORDER_COLOR, 0};
+    
+    // Control instructions
+    layers[n++] = (Layer){LAYER_TEXT, 1, 20, 45, 0, 0, SELECTED_COLOR, "Movement:"};
+    layers[n++] = (Layer){LAYER_TEXT, 1, 30, 60, 0, 0, UNSELECTED_COLOR, "↑ Up Arrow"};
+    layers[n++] = (Layer){LAYER_TEXT, 1, 30, 75, 0, 0, UNSELECTED_COLOR, "↓ Down Arrow"};
+    layers[n++] = (Layer){LAYER_TEXT, 1, 30, 90, 0, 0, UNSELECTED_COLOR, "← Left Arrow"};
+    layers[n++] = (Layer){LAYER_TEXT, 1, 30, 105, 0, 0, UNSELECTED_COLOR, "→ Right Arrow"};
+    
+    // Blinking return instruction
+    static int blink = 0;
+    blink ^= 1;
+    if(blink) {
+        layers[n++] = (Layer){LAYER_TEXT, 1, 15, 130, 0, 0, SELECTED_COLOR, "Press RIGHT to return"};
+    }
+
+    composeArea(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, layers, n);
+}
+
+/**
+ * Displays credits screen
+ */
+void showCredits() {
+    Layer layers[12];
+    int n = 0;
+    layers[n++] = (Layer){LAYER_FRAME, 0, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, BORDER_COLOR, 0};  // Border
+    
+    // Title with shadow
+    layers[n++] = (Layer){LAYER_TEXT, 2, 31, 21, 0, 0, 0, "CREDITS"};            // Shadow
+    layers[n++] = (Layer){LAYER_TEXT, 2, 30, 20, 0, 0, TITLE_COLOR, "CREDITS"};  // Main text
+    
+    // Separator lines
+    layers[n++] = (Layer){LAYER_FILL, 0, 20, 35, 88, 1, BORDER_COLOR, 0};
+    layers[n++] = (Layer){LAYER_FILL, 0, 20, 120, 88, 1, BORDER_COLOR, 0};
+    
+    // Credits content
+    layers[n++] = (Layer){LAYER_TEXT, 1, 30, 50, 0, 0, SELECTED_COLOR, "Heart Chase"};
+    layers[n++] = (Layer){LAYER_TEXT, 1, 30, 70, 0, 0, UNSELECTED_COLOR, "Created by:"};
+    layers[n++] = (Layer){LAYER_TEXT, 1, 35, 85, 0, 0, SELECTED_COLOR, "V, C, J"};
+    
+    // Decorative hearts
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 10, 45, 0, 0, 0, &pacmanheart};   // Left heart
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 106, 45, 0, 0, 0, &pacmanheart};  // Right heart
+    
+    // Blinking return instruction
+    static int blink = 0;
+    blink ^= 1;
+    if(blink) {
+        layers[n++] = (Layer){LAYER_TEXT, 1, 15, 130, 0, 0, SELECTED_COLOR, "Press RIGHT to return"};
+    }
+
+    composeArea(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, layers, n);
+}
+
+/******************************************************************************
+ * Game Over and Victory Screen Functions
+ *****************************************************************************/
+
+/**
+ * Displays the game over or victory menu
+ * Allows player to choose between replaying or returning to main menu
+ */
+void drawGameOverMenu() {
+    Layer layers[7];
+    int n = 0;
+
+    // Dark background panel with a border
+    layers[n++] = (Layer){LAYER_FILL, 0, 20, 50, 88, 60, RGB565(0, 0, 32), 0};
+    layers[n++] = (Layer){LAYER_FRAME, 0, 20, 50, 88, 61, RGB565(0, 0, 0xff), 0};
+    
+    // Display appropriate status message
+    if (game_won) {
+        layers[n++] = (Layer){LAYER_TEXT, 1, 40, 60, 0, 0, RGB565(0, 0xff, 0), "YOU WIN!"};   // Green for win
+    } else {
+        layers[n++] = (Layer){LAYER_TEXT, 1, 35, 60, 0, 0, RGB565(0xff, 0, 0), "GAME OVER"};  // Red for loss
+    }
+    
+    // Set colors for menu options based on selection
+    uint16_t play_color = (game_over_selection == 0) ? 
+        RGB565(0xff, 0xff, 0) : RGB565(0xff, 0xff, 0xff);        // Yellow/White
+    uint16_t menu_color = (game_over_selection == 1) ? 
+        RGB565(0xff, 0xff, 0) : RGB565(0xff, 0xff, 0xff);        // Yellow/White
+    
+    // Menu options
+    layers[n++] = (Layer){LAYER_TEXT, 1, 35, 80, 0, 0, play_color, "Play Again"};
+    layers[n++] = (Layer){LAYER_TEXT, 1, 35, 95, 0, 0, menu_color, "Main Menu"};
+    
+    // Pacman indicator for current selection
+    layers[n++] = (Layer){LAYER_IMAGE, 0, 25, 78 + (game_over_selection * 15), 0, 0, 0, &pac1};
+
+    composeArea(20, 50, 88, 61, layers, n);
+}
+
+/**
+ * Displays an animated victory celebration screen
+ * Shows congratulatory messages and final score
+ */
+void showWinScreen() {
+    display_scrollTo(0);
+    // The screen is a stack of layers revealed one at a time.  Each step
+    // recomposes only the area that changes, so nothing is drawn twice.
+    Layer layers[16];
+    int n = 0;
+
+    // Fade in a gradient background: dark blue rising over 128 rows, then repeating
+    uint16_t ramp[128];
+    layers[n++] = (Layer){LAYER_PATTERN, 128, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, ramp};
+    for (int level = 1; level <= FADE_LEVELS; level++) {
+        makeGradient(ramp, 128, 0, 0, 0, 0, 0, 64);
+        fade_palette(ramp, ramp, 128, level);
+        composeArea(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, layers, n);
+    }
+
+    // Play victory fanfare
+    playNote(800);  delay(200);  // Low note
+    playNote(1000); delay(200);  // Mid-low note
+    playNote(1200); delay(200);  // Mid-high note
+    playNote(1500); delay(400);  // High note
+    playNote(0);                 // Stop sound
+
+    // Golden decorative border, one side at a time
+    layers[n++] = (Layer){LAYER_FRAME, 0, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, WIN_GOLD, 0};
+    composeArea(0, 0, SCREEN_WIDTH, 1, layers, n);
+    composeArea(0, SCREEN_HEIGHT - 1, SCREEN_WIDTH, 1, layers, n);
+    composeArea(0, 1, 1, SCREEN_HEIGHT - 2, layers, n);
+    composeArea(SCREEN_WIDTH - 1, 1, 1, SCREEN_HEIGHT - 2, layers, n);
+
+    // Animate hearts appearing in corners
+    static const uint16_t heart_x[] = {5, 111, 5, 111};
+    static const uint16_t heart_y[] = {5, 5, 139, 139};
+    for(int i = 0; i < 4; i++) {
+        delay(100);  // Pause between each heart
+        layers[n++] = (Layer){LAYER_IMAGE, 0, heart_x[i], heart_y[i], 0, 0, 0, &pacmanheart};
+        composeArea(heart_x[i], heart_y[i], pacmanheart.Width, pacmanheart.Height, layers, n);
+    }
+
+    // Display main victory text with shadow effect
+    const char* win_text = "YOU WIN!";
+    int text_x = 25;
+    int text_y = 40;
+    int text_w = strlen(win_text) * 12 - 2;  // 10 pixel wide characters 2 apart
+    
+    layers[n++] = (Layer){LAYER_TEXT, 2, text_x + 1, text_y + 1, 0, 0, 0, win_text};  // Shadow
+    layers[n++] = (Layer){LAYER_TEXT, 2, text_x, text_y, 0, 0, WIN_GOLD, win_text};   // Main text
+    composeArea(text_x, text_y, text_w + 1, 15, layers, n);
+    
+    delay(500);  // Pause for emphasis
+
+    // Animate separator lines, 4 pixels per step
+    Layer *upper = &layers[n++];
+    Layer *lower = &layers[n++];
+    *upper = (Layer){LAYER_FILL, 0, 20, 65, 0, 1, WIN_PINK, 0};    // Upper line grows right
+    *lower = (Layer){LAYER_FILL, 0, 104, 95, 0, 1, WIN_PINK, 0};   // Lower line grows left
+    for(int i = 20; i < 108; i += 4) {
+        upper->w += 4;
+        lower->x = 124 - i;
+        lower->w += 4;
+        composeArea(i, 65, 4, 1, layers, n);
+        composeArea(124 - i, 95, 4, 1, layers, n);
+        delay(1);                            // Slow animation
+    }
+
+    // Display congratulatory messages with fade-in effect
+    const char* messages[] = {
+        "CONGRATULATIONS!",
+        "ALL HEARTS",
+        "COLLECTED!",
+        "YOU'RE Eating!"
+    };
+    
+    // Show each message with alternating colors, brightening over about 200ms
+    for(int i = 0; i < 4; i++) {
+        int y_pos = 70 + (i * 20);
+        int x_pos = 64 - (strlen(messages[i]) * 3);  // Center text
+        Layer *message = &layers[n++];
+        *message = (Layer){LAYER_TEXT, 1, x_pos, y_pos, 0, 0, 0, messages[i]};
+        for (int level = 1; level <= FADE_LEVELS; level++) {
+            message->Colour = fade_colour((i % 2) ? WIN_PINK : WIN_BLUE, level);  // Alternate colors
+            composeArea(x_pos, y_pos, strlen(messages[i]) * 7 - 2, 7, layers, n);
+            delay(200 / FADE_LEVELS);
+        }
+    }
+
+    // Display final level count
+    delay(200);
+    char score_text[20];
+    sprintf(score_text, "LEVELS: %d", current_level);
+    layers[n++] = (Layer){LAYER_TEXT, 1, 40, 140, 0, 0, WIN_GOLD, score_text};
+    composeArea(40, 140, strlen(score_text) * 7 - 2, 7, layers, n);
+
+    // Log victory to serial output
+    eputs("Game Won! All hearts collected in both levels!\r\n");
+}
+
+/******************************************************************************
+ * Main Function - Game Initialization
+ *****************************************************************************/
+int main() {
+    // Movement and direction control flags
+    int hinverted = 0;    // Horizontal flip flag
+    int vinverted = 0;    // Vertical flip flag
+    int toggle = 0;       // Animation toggle
+    int hmoved = 0;       // Horizontal movement flag
+    int vmoved = 0;       // Vertical movement flag
+    
+    // Player position tracking
+    uint16_t x = 50;      // Current X position
+    uint16_t y = 50;      // Current Y position
+    const PalImage *pacman_frame = &pac1;  // Current player sprite
+    int pacman_hflip = 0, pacman_vflip = 0;  // and its orientation
+    int pacman_transpose = 0;
+    DisplayStats frame_stats = {0, 0, 0};  // Display command traffic of the last frame
+    uint32_t render_cycles = 0;            // Time tiles_render took in the last frame
+    uint16_t render_sprites = 0;           // and the number of sprites it redrew
+
+    /*** Hardware Initialization ***/
+    initClock();          // Initialize system clock
+    initSysTick();        // Initialize system timer
+    setupIO();            // Setup input/output pins
+    initSerial();         // Initialize serial communication
+    initEnemies();        // Initialize enemy positions and states
+    //initSound();
+    hud_init(&hud_hearts, 48, HUD_Y, 1, 1, 0, HUD_COLOR, 0);
+    hud_init(&hud_time, 100, HUD_Y, 3, 1, 0, HUD_COLOR, 0);
+
+    /*** Sound System Setup ***/
+    // The startup tune is the background tune, played by SysTick so that
+    // boot does not wait for it
+    background_tune_notes = my_notes;
+    background_tune_times = my_note_times;
+    background_tune_note_count = 5;
+    background_repeat_tune = 1;
+
+    /*** Draw Initial Game Screen ***/
+    // The display has been powering up in the background since setupIO
+    while (!display_poll(milliseconds)) {
+        __asm(" wfi ");
+    }
+    drawBackground();     // Draw maze and game environment
+    eputs("First frame at ");
+    printDecimal(milliseconds);
+    eputs(" ms\r\n");
+
+/******************************************************************************
+ * Main Game Loop
+ *****************************************************************************/
+    while (1) {
+        // Keep the previous frame's display counts for the 's' report
+        display_getStats(&frame_stats);
+        display_resetStats();
+
+        // Handle serial input
+        char serial_char = serial_available() ? egetchar() : 0;
+
+        // Report display command traffic for the last frame
+        if (serial_char == 's') {
+            eputs("Apertures: ");
+            printDecimal(frame_stats.Apertures);
+            eputs(" command bytes: ");
+            printDecimal(frame_stats.CommandBytes);
+            eputs(" saved: ");
+            printDecimal(frame_stats.SavedBytes);
+            eputs(" render us: ");
+            printDecimal(render_cycles / 48);
+            eputs(" sprites: ");
+            printDecimal(render_sprites);
+            eputs("\r\n");
+        }
+
+        /*** Screen Transitions ***/
+        // The game waits while a new screen comes in; sound carries on from SysTick
+        if (transition_poll(milliseconds)) {
+            game_second_mark = milliseconds;  // The clock starts with the game
+            __asm(" wfi ");
+            continue;
+        }
+        if (level_banner) {
+            // The banner has been held, now the level 2 maze
+            level_banner = 0;
+            startGameScreen(TRANSITION_DISSOLVE);
+            continue;
+        }
+
+        /*** Menu State Handling ***/
+        if (in_menu) {
+            // Draw menu on first entry
+            static int menu_drawn = 0;
+            if (!menu_drawn) {
+                drawMenu();
+                menu_drawn = 1;
+                last_input_time = milliseconds;
+            }
+
+            // Let the panel save power while the menu is left alone
+            __asm(" wfi ");
+            if (screenPowerPolicy()) {
+                continue;
+            }
+
+            // Menu Navigation Controls
+            // Down Button
+            if ((GPIOA->IDR & (1 << 11)) == 0) {
+                delay(200);  // Prevent multiple inputs
+                selected_option = (selected_option + 1) % NUM_MENU_OPTIONS;
+                drawMenu();
+            }
+            // Up Button
+            if ((GPIOA->IDR & (1 << 8)) == 0) {
+                delay(200);
+                selected_option = (selected_option - 1 + NUM_MENU_OPTIONS) % NUM_MENU_OPTIONS;
+                drawMenu();
+            }
+            // Select Button (Right/Enter)
+            if ((GPIOB->IDR & (1 << 4)) == 0) {
+                delay(200);
+                
+                switch(selected_option) {
+                    case 0:  // Start New Game
+                        // Reset game state and screen
+                        in_menu = 0;
+                        menu_drawn = 0;
+                        startGameScreen(TRANSITION_WIPE);   // Wipe the maze in
+                        initEnemies();                     // Setup enemies
+                        
+                        // Reset game flags
+                        game_over = 0;
+                        game_won = 0;
+                        heart1_eaten = 0;
+                        heart2_eaten = 0;
+                        
+                        // Reset positions
+                        x = 50; y = 50;           // Player position
+                        heart1_x = 40; heart1_y = 80;  // Heart 1 position
+                        heart2_x = 60; heart2_y = 90;  // Heart 2 position
+                        game_seconds = 0;
+                        game_second_mark = milliseconds;
+                        break;
+                        
+                    case 1:  // Show Controls Screen
+                        showControls();
+                        while(screenPowerPolicy() || (GPIOB->IDR & (1 << 4)) != 0) {  // Wait for the button
+                            __asm(" wfi ");
+                        }
+                        delay(200);
+                        drawMenu();
+                        break;
+                        
+                    case 2:  // Show Credits Screen
+                        showCredits();
+                        while(screenPowerPolicy() || (GPIOB->IDR & (1 << 4)) != 0) {
+                            __asm(" wfi ");
+                        }
+                        delay(200);
+                        drawMenu();
+                        break;
+                }
+            }
+            continue;  // Skip game logic while in menu
+        }
+
+        /*** Game State Updates ***/
+        hmoved = vmoved = 0;           // Reset movement flags
+        hinverted = vinverted = 0;     // Reset direction flags
+        
+        checkWinCondition(x, y);       // Check if level complete
+        if(!game_won) {
+            moveEnemies(x, y);         // Update enemy positions
+        }
+
+        /*** Player Movement ***/
+        if (!game_over && !game_won) {
+            // Right Movement
+            if (((GPIOB->IDR & (1 << 4)) == 0) || (serial_char == 'r')) {
+                if (x < SCREEN_WIDTH - 1 - PACMAN_WIDTH) {
+                    x = x + 1;
+                    hmoved = 1;
+                    hinverted = 0;
+                }
+            }
+            // Left Movement
+            if ((GPIOB->IDR & (1 << 5)) == 0) {
+                if (x > 2) {
+                    x = x - 1;
+                    hmoved = 1;
+                    hinverted = 1;
+                }
+            }
+            // Down Movement (the player turns to face down unless it also moved sideways)
+            if ((GPIOA->IDR & (1 << 11)) == 0) {
+                if (y < MAZE_HEIGHT - (hmoved ? PACMAN_HEIGHT : PACMAN_WIDTH)) {
+                    y = y + 1;
+                    vmoved = 1;
+                    vinverted = 0;
+                }
+            }
+            // Up Movement
+            if ((GPIOA->IDR & (1 << 8)) == 0) {
+                if (y > 1) {
+                    y = y - 1;
+                    vmoved = 1;
+                    vinverted = 1;
+                }
+            }
+        }
+
+        /*** Update Player Position ***/
+        if (vmoved || hmoved) {
+            // Animate the right facing frames, turned to the direction of travel
+            pacman_frame = toggle ? &pac1 : &pacman2;
+            toggle ^= 1;  // Switch animation frame
+            if (hmoved) {
+                pacman_hflip = hinverted;
+                pacman_vflip = 0;
+                pacman_transpose = 0;
+            } else {
+                pacman_hflip = 0;
+                pacman_vflip = vinverted;  // Up
+                pacman_transpose = 1;
+            }
+
+            // Turned up or down the player is wider than it is tall; keep it in the maze.
+            // Collisions test its top left corner, which is x,y whichever way it faces.
+            uint16_t pacman_w = pacman_transpose ? PACMAN_HEIGHT : PACMAN_WIDTH;
+            uint16_t pacman_h = pacman_transpose ? PACMAN_WIDTH : PACMAN_HEIGHT;
+            if (x > SCREEN_WIDTH - 1 - pacman_w) x = SCREEN_WIDTH - 1 - pacman_w;
+            if (y > MAZE_HEIGHT - pacman_h) y = MAZE_HEIGHT - pacman_h;
+
+            /*** Heart Collection Checks ***/
+            // Heart 1 Collection
+            if (!heart1_eaten && isInside(heart1_x, heart1_y, 12, 16, x, y)) {
+                showHudMessage("Mahal Kita");
+                heart1_eaten = 1;
+                
+                // Play collection sound
+                playNote(500);
+                delay(500);
+                playNote(0);
+                
+                GPIOA->ODR |= (1 << 0);  // Turn on red LED
+                eputs("Pacman eats the heart 1\r\n");
+                checkWinCondition(x, y);
+            }
+
+            // Heart 2 Collection
+            if (!heart2_eaten && isInside(heart2_x, heart2_y, 12, 16, x, y)) {
+                showHudMessage("Mama");
+                heart2_eaten = 1;
+                
+                // Play collection sound
+                playNote(500);
+                delay(500);
+                playNote(0);
+                
+                eputs("Pacman eats the heart 2\r\n");
+                checkWinCondition(x, y);
+            }
+        }
+
+
+
+/******************************************************************************
+ * Heart Movement and Collision System
+ *****************************************************************************/
+        // Update hearts every 400ms if game is active
+        if (milliseconds - heart_move_delay >= 400 && !game_over && !transition_active()) {
+            
+            /*** Heart 1 Movement ***/
+            if (!heart1_eaten) {
+                // Calculate random movement direction
+                heart1_direction_x = (rand() % 3) - 1;  // -1, 0, or 1
+                heart1_direction_y = (rand() % 3) - 1;
+                
+                // Move heart by 3 pixels in chosen direction
+                heart1_x += 3 * heart1_direction_x;
+                heart1_y += 3 * heart1_direction_y;
+
+                // Keep heart within screen boundaries
+                if (heart1_x <= 0) heart1_x = 0;
+                if (heart1_x >= MAX_X) heart1_x = MAX_X;
+                if (heart1_y <= 0) heart1_y = 0;
+                if (heart1_y >= MAX_Y) heart1_y = MAX_Y;
+            }
+
+            /*** Heart 2 Movement ***/
+            if (!heart2_eaten) {
+                // Similar movement pattern as heart 1
+                heart2_direction_x = (rand() % 3) - 1;
+                heart2_direction_y = (rand() % 3) - 1;
+                heart2_x += 3 * heart2_direction_x;
+                heart2_y += 3 * heart2_direction_y;
+
+                // Boundary checks
+                if (heart2_x <= 0) heart2_x = 0;
+                if (heart2_x >= MAX_X) heart2_x = MAX_X;
+                if (heart2_y <= 0) heart2_y = 0;
+                if (heart2_y >= MAX_Y) heart2_y = MAX_Y;
+            }
+
+            /*** Level 2 Additional Hearts ***/
+            if (current_level == 2) {
+                // Heart 3 Movement
+                if (!heart3_eaten) {
+                    heart3_direction_x = (rand() % 3) - 1;
+                    heart3_direction_y = (rand() % 3) - 1;
+                    heart3_x += 3 * heart3_direction_x;
+                    heart3_y += 3 * heart3_direction_y;
+                    
+                    // Boundary checks
+                    if (heart3_x <= 0) heart3_x = 0;
+                    if (heart3_x >= MAX_X) heart3_x = MAX_X;
+                    if (heart3_y <= 0) heart3_y = 0;
+                    if (heart3_y >= MAX_Y) heart3_y = MAX_Y;
+                }
+
+                // Heart 4 Movement
+                if (!heart4_eaten) {
+                    // Similar pattern as other hearts
+                    heart4_direction_x = (rand() % 3) - 1;
+                    heart4_direction_y = (rand() % 3) - 1;
+                    heart4_x += 3 * heart4_direction_x;
+                    heart4_y += 3 * heart4_direction_y;
+                    
+                    // Boundary checks
+                    if (heart4_x <= 0) heart4_x = 0;
+                    if (heart4_x >= MAX_X) heart4_x = MAX_X;
+                    if (heart4_y <= 0) heart4_y = 0;
+                    if (heart4_y >= MAX_Y) heart4_y = MAX_Y;
+                }
+            }
+
+            /*** Enemy Collision Check ***/
+            if(!game_won && checkEnemyCollision(x, y)) {
+                game_over = 1;  // Game ends if player hits enemy
+                
+                // Clear entire screen (the sprites go with it)
+                display_scrollTo(0);
+                fillRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+
+                // Remove all active enemies
+                for(int i = 0; i < MAX_ENEMIES; i++) {
+                    enemies[i].active = 0;
+                }
+                boss.active = 0;
+
+                // Show game over menu
+                show_game_over_menu = 1;
+                game_over_selection = 0;
+                drawGameOverMenu();
+                display_setPartial(50, 110);  // Everything else is black
+                last_input_time = milliseconds;
+            }
+
+            // Reset movement timer
+            heart_move_delay = milliseconds;
+        }
+        /******************************************************************************
+         * Level 2 Heart Collection Logic
+         *****************************************************************************/
+        if (current_level == 2 && !transition_active()) {
+            // Check collision with Heart 3
+            if (!heart3_eaten && isInside(heart3_x, heart3_y, 12, 16, x, y)) {
+                showHudMessage("Heart 3!");                                  // Show collection message
+                heart3_eaten = 1;                                             // Mark as collected
+                
+                // Play collection sound effect
+                playNote(500);
+                delay(500);
+                playNote(0);
+                
+                eputs("Pacman eats heart 3\r\n");                            // Log to serial
+                checkWinCondition(x, y);                                     // Check if level complete
+            }
+
+            // Check collision with Heart 4 (same pattern as Heart 3)
+            if (!heart4_eaten && isInside(heart4_x, heart4_y, 12, 16, x, y)) {
+                showHudMessage("Heart 4!");
+                heart4_eaten = 1;
+                
+                playNote(500);
+                delay(500);
+                playNote(0);
+                
+                eputs("Pacman eats heart 4\r\n");
+                checkWinCondition(x, y);
+            }
+        }
+
+        /******************************************************************************
+         * Game Over/Win Menu Navigation
+         *****************************************************************************/
+        if (game_over || game_won) {
+            // Let the panel save power while the menu is left alone
+            if (screenPowerPolicy()) {
+                continue;
+            }
+
+            // Handle menu navigation with up/down buttons
+            if ((GPIOA->IDR & (1 << 11)) == 0) {  // Down pressed
+                delay(200);                        // Debounce delay
+                game_over_selection = !game_over_selection;  // Toggle selection
+                drawGameOverMenu();                // Redraw menu
+            }
+            if ((GPIOA->IDR & (1 << 8)) == 0) {   // Up pressed
+                delay(200);
+                game_over_selection = !game_over_selection;
+                drawGameOverMenu();
+            }
+
+            // Handle selection confirmation
+            if ((GPIOB->IDR & (1 << 4)) == 0) {   // Right/Enter pressed
+                delay(200);
+                
+                if (game_over_selection == 0) {    // "Play Again" selected
+                    // Reset game state to level 1
+                    current_level = 1;
+                    game_over = 0;
+                    game_won = 0;
+                    heart1_eaten = 0;
+                    heart2_eaten = 0;
+                    heart3_eaten = 0;
+                    heart4_eaten = 0;
+                    show_game_over_menu = 0;
+                    
+                    // Reset player and heart positions
+                    x = 50;
+                    y = 50;
+                    heart1_x = 40;
+                    heart1_y = 80;
+                    heart2_x = 60;
+                    heart2_y = 90;
+                    game_seconds = 0;
+                    game_second_mark = milliseconds;
+                    
+                    // Reset game display
+                    display_setNormal();                  // Whole panel again
+                    startGameScreen(TRANSITION_BLINDS);   // Bring the maze in
+                    initEnemies();                       // Reset enemies
+                    
+                } else {  // "Main Menu" selected
+                    in_menu = 1;                         // Return to main menu
+                    display_setNormal();                 // Whole panel again
+                    show_game_over_menu = 0;             // Hide game over menu
+                    current_level = 1;                   // Reset to level 1
+                }
+            }
+        }
+
+        /*** Redraw the playfield ***/
+        if (!game_over && !game_won && !transition_active()) {
+            updateSprites(x, y, pacman_frame, pacman_hflip, pacman_vflip, pacman_transpose);
+            // Keep the player near the middle of the screen on tall mazes
+            tiles_scrollTo((y > 72) ? y - 72 : 0);
+            uint32_t render_start = readCycles();
+            render_sprites = tiles_render();
+            render_cycles = readCycles() - render_start;
+
+            // HUD: only the digits that changed are sent
+            if (milliseconds - game_second_mark >= 1000) {
+                game_second_mark += 1000;
+                game_seconds++;
+            }
+            if (hud_message && milliseconds - hud_message_time >= HUD_MESSAGE_MS) {
+                hud_message = 0;
+                drawHud();  // Labels back; the numbers follow below
+            }
+            if (!hud_message) {
+                hud_setNumber(&hud_hearts, hearts_collected);
+                hud_setNumber(&hud_time, game_seconds);
+            }
+        }
+
+        delay(20);  // Control game speed
+    }
+
+    return 0;  // End of main function
+}
+
+
+void initSysTick(void)
+{
+	SysTick->LOAD = 48000;
+	SysTick->CTRL = 7;
+	SysTick->VAL = 10;
+	__asm(" cpsie i "); // enable interrupts
+}
+uint32_t readCycles(void)
+{
+	// Cycles since start up from the millisecond count and the SysTick down
+	// counter (48 per microsecond); wraps after about 89 seconds
+	uint32_t ms, count;
+	do
+	{
+		ms = milliseconds;
+		count = SysTick->VAL;
+	} while (ms != milliseconds);  // a tick came in between
+	return ms * 48000 + (SysTick->LOAD - count);
+}
+void SysTick_Handler(void)
+{
+	milliseconds++;
+    static int index = 0;
+    static int current_note_timer;
+    //Background tune handler
+    if (background_tune_notes !=0)
+    {
+        //if there is no tune
+        if (current_note_timer == 0)
+        {
+            //. move on to the next note (if there is none)
+            index ++;
+            if (index >= background_tune_note_count)
+            {
+                // no more notes
+                if (background_repeat_tune == 0)
+                {
+                    //dont repeat
+                    background_tune_notes = 0;
+                }
+                else
+                {
+                    index = 0; //reset to first note and repeat
+                }
+            }
+            else
+            {
+                current_note_timer = background_tune_times[index];
+                playNote(background_tune_notes[index]);
+            }
+        }
+        if(current_note_timer != 0)
+        {
+            current_note_timer --;
+        }
+
+
+    }
+}
+void initClock(void)
+{
+// This is potentially a dangerous function as it could
+// result in a system with an invalid clock signal - result: a stuck system
+        // Set the PLL up
+        // First ensure PLL is disabled
+        RCC->CR &= ~(1u<<24);
+        while( (RCC->CR & (1 <<25))); // wait for PLL ready to be cleared
+        
+// Warning here: if system clock is greater than 24MHz then wait-state(s) need to be
+// inserted into Flash memory interface
+				
+        FLASH->ACR |= (1 << 0);
+        FLASH->ACR &=~((1u << 2) | (1u<<1));
+        // Turn on FLASH prefetch buffer
+        FLASH->ACR |= (1 << 4);
+        // set PLL multiplier to 12 (yielding 48MHz)
+        RCC->CFGR &= ~((1u<<21) | (1u<<20) | (1u<<19) | (1u<<18));
+        RCC->CFGR |= ((1<<21) | (1<<19) ); 
+
+        // Need to limit ADC clock to below 14MHz so will change ADC prescaler to 4
+        RCC->CFGR |= (1<<14);
+
+        // and turn the PLL back on again
+        RCC->CR |= (1<<24);        
+        // set PLL as system clock source 
+        RCC->CFGR |= (1<<1);
+}
+void delay(volatile uint32_t dly)
+{
+	uint32_t end_time = dly + milliseconds;
+	while(milliseconds != end_time)
+		__asm(" wfi "); // sleep
+}
+
+void enablePullUp(GPIO_TypeDef *Port, uint32_t BitNumber)
+{
+	Port->PUPDR = Port->PUPDR &~(3u << BitNumber*2); // clear pull-up resistor bits
+	Port->PUPDR = Port->PUPDR | (1u << BitNumber*2); // set pull-up bit
+}
+void pinMode(GPIO_TypeDef *Port, uint32_t BitNumber, uint32_t Mode)
+{
+	/*
+	*/
+	uint32_t mode_value = Port->MODER;
+	Mode = Mode << (2 * BitNumber);
+	mode_value = mode_value & ~(3u << (BitNumber * 2));
+	mode_value = mode_value | Mode;
+	Port->MODER = mode_value;
+}
+int isInside(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h, uint16_t px, uint16_t py)
+{
+	// checks to see if point px,py is within the rectange defined by x,y,w,h
+	uint16_t x2,y2;
+	x2 = x1+w;
+	y2 = y1+h;
+	int rvalue = 0;
+	if ( (px >= x1) && (px <= x2))
+	{
+		// ok, x constraint met
+		if ( (py >= y1) && (py <= y2))
+			rvalue = 1;
+	}
+	return rvalue;
+}
+
+void setupIO()
+{
+	RCC->AHBENR |= (1 << 18) + (1 << 17); // enable Ports A and B
+	display_start(milliseconds);  // finished by display_poll in main
+	pinMode(GPIOB,4,0);
+	pinMode(GPIOB,5,0);
+	pinMode(GPIOA,8,0);
+	pinMode(GPIOA,11,0);
+    pinMode(GPIOA,12,0);//for the red led cant get it working
+	enablePullUp(GPIOB,4);
+	enablePullUp(GPIOB,5);
+	enablePullUp(GPIOA,11);
+	enablePullUp(GPIOA,8);
+}
+
+
+
+
+
+
+
+
+
+
+
+
@@ -1,111 +1,111 @@
-// Rounded musical note frequencies
-// 'S' is used in place of # (sharp) as that has a special meaning in C
-// DS2_Eb2 is D#2 / Eb2 
-#define C0	16
-#define CS0_Db0	17
-#define D0	18
-#define DS0_Eb0	19
-#define E0	21
-#define F0	22
-#define FS0_Gb0	23
-#define G0	25
-#define GS0_Ab0	26
-#define A0	28
-#define AS0_Bb0	29
-#define B0	31
-#define C1	33
-#define CS1_Db1	35
-#define D1	37
-#define DS1_Eb1	39
-#define E1	41
-#define F1	44
-#define FS1_Gb1	46
-#define G1	49
-#define GS1_Ab1	52
-#define A1	55
-#define AS1_Bb1	58
-#define B1	62
-#define C2	65
-#define CS2_Db2	69
-#define D2	73
-#define DS2_Eb2	78
-#define E2	82
-#define F2	87
-#define FS2_Gb2	93
-#define G2	98
-#define GS2_Ab2	104
-#define A2	110
-#define AS2_Bb2	117
-#define B2	123
-#define C3	131
-#define CS3_Db3	139
-#define D3	147
-#define DS3_Eb3	156
-#define E3	165
-#define F3	175
-#define FS3_Gb3	185
-#define G3	196
-#define GS3_Ab3	208
-#define A3	220
-#define AS3_Bb3	233
-#define B3	247
-#define C4	262
-#define CS4_Db4	277
-#define D4	294
-#define DS4_Eb4	311
-#define E4	330
-#define F4	349
-#define FS4_Gb4	370
-#define G4	392
-#define GS4_Ab4	415
-#define A4	440
-#define AS4_Bb4	466
-#define B4	494
-#define C5	523
-#define CS5_Db5	554
-#define D5	587
-#define DS5_Eb5	622
-#define E5	659
-#define F5	698
-#define FS5_Gb5	740
-#define G5	784
-#define GS5_Ab5	831
-#define A5	880
-#define AS5_Bb5	932
-#define B5	988
-#define C6	1047
-#define CS6_Db6	1109
-#define D6	1175
-#define DS6_Eb6	1245
-#define E6	1319
-#define F6	1397
-#define FS6_Gb6	1480
-#define G6	1568
-#define GS6_Ab6	1661
-#define A6	1760
-#define AS6_Bb6	1865
-#define B6	1976
-#define C7	2093
-#define CS7_Db7	2217
-#define D7	2349
-#define DS7_Eb7	2489
-#define E7	2637
-#define F7	2794
-#define FS7_Gb7	2960
-#define G7	3136
-#define GS7_Ab7	3322
-#define A7	3520
-#define AS7_Bb7	3729
-#define B7	3951
-#define C8	4186
-#define CS8_Db8	4435
-#define D8	4699
-#define DS8_Eb8	4978
-#define E8	5274
-#define F8	5588
-#define FS8_Gb8	5920
-#define G8	6272
-#define GS8_Ab8	6645
-#define A8	7040
-#define AS8_Bb8	7459
-#define B8	7902
+// Rounded musical note frequencies
+// 'S' is used in place of # (sharp) as that has a special meaning in C
+// DS2_Eb2 is D#2 / Eb2 
+#define C0	16
+#define CS0_Db0	17
+#define D0	18
+#define DS0_Eb0	19
+#define E0	21
+#define F0	22
+#define FS0_Gb0	23
+#define G0	25
+#define GS0_Ab0	26
+#define A0	28
+#define AS0_Bb0	29
+#define B0	31
+#define C1	33
+#define CS1_Db1	35
+#define D1	37
+#define DS1_Eb1	39
+#define E1	41
+#define F1	44
+#define FS1_Gb1	46
+#define G1	49
+#define GS1_Ab1	52
+#define A1	55
+#define AS1_Bb1	58
+#define B1	62
+#define C2	65
+#define CS2_Db2	69
+#define D2	73
+#define DS2_Eb2	78
+#define E2	82
+#define F2	87
+#define FS2_Gb2	93
+#define G2	98
+#define GS2_Ab2	104
+#define A2	110
+#define AS2_Bb2	117
+#define B2	123
+#define C3	131
+#define CS3_Db3	139
+#define D3	147
+#define DS3_Eb3	156
+#define E3	165
+#define F3	175
+#define FS3_Gb3	185
+#define G3	196
+#define GS3_Ab3	208
+#define A3	220
+#define AS3_Bb3	233
+#define B3	247
+#define C4	262
+#define CS4_Db4	277
+#define D4	294
+#define DS4_Eb4	311
+#define E4	330
+#define F4	349
+#define FS4_Gb4	370
+#define G4	392
+#define GS4_Ab4	415
+#define A4	440
+#define AS4_Bb4	466
+#define B4	494
+#define C5	523
+#define CS5_Db5	554
+#define D5	587
+#define DS5_Eb5	622
+#define E5	659
+#define F5	698
+#define FS5_Gb5	740
+#define G5	784
+#define GS5_Ab5	831
+#define A5	880
+#define AS5_Bb5	932
+#define B5	988
+#define C6	1047
+#define CS6_Db6	1109
+#define D6	1175
+#define DS6_Eb6	1245
+#define E6	1319
+#define F6	1397
+#define FS6_Gb6	1480
+#define G6	1568
+#define GS6_Ab6	1661
+#define A6	1760
+#define AS6_Bb6	1865
+#define B6	1976
+#define C7	2093
+#define CS7_Db7	2217
+#define D7	2349
+#define DS7_Eb7	2489
+#define E7	2637
+#define F7	2794
+#define FS7_Gb7	2960
+#define G7	3136
+#define GS7_Ab7	3322
+#define A7	3520
+#define AS7_Bb7	3729
+#define B7	3951
+#define C8	4186
+#define CS8_Db8	4435
+#define D8	4699
+#define DS8_Eb8	4978
+#define E8	5274
+#define F8	5588
+#define FS8_Gb8	5920
+#define G8	6272
+#define GS8_Ab8	6645
+#define A8	7040
+#define AS8_Bb8	7459
+#define B8	7902
@@ -1,8 +1,8 @@
-#include <stdint.h>
-
-void initSerial(void);
-void eputchar(char c);
-char egetchar(void);
-void eputs(char *String);
-void printDecimal(int32_t Value);
-int serial_available(void);//for serial
+#include <stdint.h>
+
+void initSerial(void);
+void eputchar(char c);
+char egetchar(void);
+void eputs(char *String);
+void printDecimal(int32_t Value);
+int serial_available(void);//for serial
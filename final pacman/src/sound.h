@@ -1,3 +1,3 @@
-#include <stdint.h>
-void playNote(uint32_t Freq);
+#include <stdint.h>
+void playNote(uint32_t Freq);
 void initSound(void);
\ No newline at end of file
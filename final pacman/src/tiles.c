@@ -0,0 +1,439 @@
+#include <stm32f031x6.h>
+#include "display.h"
+#include "tiles.h"
+#define TILES_MAX_RUN 8   // widest strip composed in one go, in tiles
+#define ROW_BUFFER_SIZE (TILES_MAX_RUN * TILE_SIZE)
+#define MAP_WIDTH (TILE_COLS * TILE_SIZE)
+#define VIEW_HEIGHT (TILE_ROWS * TILE_SIZE)
+
+// A sprite slot
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+	uint16_t w;
+	uint16_t h;
+	const PalImage *Pal;
+	uint8_t hOrientation;
+	uint8_t vOrientation;
+	uint8_t Transposed;         // image rows run down the screen
+	uint8_t Scale;              // screen pixels per image pixel each way
+	uint8_t Shown;              // to be drawn at x,y
+	uint8_t Changed;            // moved, changed frame or was hidden since the last render
+	uint8_t OnScreen;           // drawn at ox,oy by the last render
+	uint16_t ox;
+	uint16_t oy;
+	uint16_t ow;
+	uint16_t oh;
+} TileSprite;
+
+static void composeRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Line, const TileSprite *List, uint16_t Count);
+static void composeClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const TileSprite *List, uint16_t Count);
+static void overlaySprite(const TileSprite *Sprite, uint16_t x0, uint16_t w, uint16_t y);
+static void overlayPal12(uint16_t *Dst, const uint8_t *PalRow, const uint16_t *Palette);
+static void overlayPal12Mirrored(uint16_t *Dst, const uint8_t *PalRow, const uint16_t *Palette);
+static void composeUnion(const TileSprite *Sprite);
+// One byte of a palette row: two pixels, left one in the high nibble, written to
+// Dst[L] and Dst[R] unless transparent
+#define OVERLAY_PAIR(Byte, L, R) \
+	do { \
+		uint8_t b = (Byte); \
+		if (b >> 4) \
+			Dst[L] = Palette[b >> 4]; \
+		if (b & 0x0f) \
+			Dst[R] = Palette[b & 0x0f]; \
+	} while (0)
+static void overlayPal12(uint16_t *Dst, const uint8_t *PalRow, const uint16_t *Palette)
+{
+	// A 12 pixel palette row unrolled.  The Cortex-M0 cannot load a word from an odd
+	// address, and rows are 6 bytes apart, so the row is read a byte at a time.
+	OVERLAY_PAIR(PalRow[0], 0, 1);
+	OVERLAY_PAIR(PalRow[1], 2, 3);
+	OVERLAY_PAIR(PalRow[2], 4, 5);
+	OVERLAY_PAIR(PalRow[3], 6, 7);
+	OVERLAY_PAIR(PalRow[4], 8, 9);
+	OVERLAY_PAIR(PalRow[5], 10, 11);
+}
+static void overlayPal12Mirrored(uint16_t *Dst, const uint8_t *PalRow, const uint16_t *Palette)
+{
+	OVERLAY_PAIR(PalRow[0], 11, 10);
+	OVERLAY_PAIR(PalRow[1], 9, 8);
+	OVERLAY_PAIR(PalRow[2], 7, 6);
+	OVERLAY_PAIR(PalRow[3], 5, 4);
+	OVERLAY_PAIR(PalRow[4], 3, 2);
+	OVERLAY_PAIR(PalRow[5], 1, 0);
+}
+static void setSprite(TileSprite *Sprite, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const PalImage *Pal, int hOrientation, int vOrientation, int Transpose);
+static int clipView(uint16_t *y, uint16_t *h);
+static uint16_t viewLine(uint16_t y);
+
+static const uint8_t (*TileMap)[TILE_COLS];
+static uint16_t MapRows;
+static uint16_t TileColours[2];              // path and wall colours
+// The screen shows map rows ViewY to ViewY+VIEW_HEIGHT-1.  Frame memory is used as a
+// ring: map row ViewY is in frame memory row ViewLine and the display's vertical
+// scroll start is kept at ViewLine, so scrolling only needs the new rows drawn.
+static uint16_t ViewY;
+static uint16_t ViewLine;
+static TileSprite Sprites[TILES_MAX_SPRITES];
+static uint16_t RowBuffer[ROW_BUFFER_SIZE];
+
+void tiles_setMap(const uint8_t (*Map)[TILE_COLS], uint16_t Rows, uint16_t PathColour, uint16_t WallColour)
+{
+	// Rows can be more than fit on the screen; the view starts at the top
+	TileMap = Map;
+	MapRows = (Rows > TILES_MAX_ROWS) ? TILES_MAX_ROWS : Rows;
+	ViewY = 0;
+	ViewLine = 0;
+	display_setScrollArea(0, VIEW_HEIGHT);
+	tiles_setColours(PathColour, WallColour);
+}
+void tiles_setColours(uint16_t PathColour, uint16_t WallColour)
+{
+	// Takes effect as the tiles are next drawn
+	TileColours[0] = PathColour;
+	TileColours[1] = WallColour;
+}
+void tiles_drawAll()
+{
+	// Compose the whole view, sprites included, so that each pixel is sent once.
+	// Every sprite is then up to date on the screen.
+	uint16_t i, Rows;
+	TileSprite *Sprite;
+	display_scrollTo(ViewLine);
+	Rows = MapRows * TILE_SIZE - ViewY;  // a short map leaves the rest of the view alone
+	if (Rows > VIEW_HEIGHT)
+		Rows = VIEW_HEIGHT;
+	composeClipped(0, ViewY, MAP_WIDTH, Rows, Sprites, TILES_MAX_SPRITES);
+	for (i = 0; i < TILES_MAX_SPRITES; i++)
+	{
+		Sprite = &Sprites[i];
+		Sprite->OnScreen = Sprite->Shown;
+		Sprite->ox = Sprite->x;
+		Sprite->oy = Sprite->y;
+		Sprite->ow = Sprite->w;
+		Sprite->oh = Sprite->h;
+		Sprite->Changed = 0;
+	}
+}
+void tiles_drawArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	// Compose part of the view, in screen coordinates, for bringing the map in a
+	// piece at a time.  Sprites in the area are drawn but not marked as drawn, so
+	// tiles_render still draws every sprite that has changed.
+	uint16_t Rows = MapRows * TILE_SIZE - ViewY;
+	if (y >= Rows)
+		return;
+	if (y + h > Rows)
+		h = Rows - y;
+	composeClipped(x, ViewY + y, w, h, Sprites, TILES_MAX_SPRITES);
+}
+void tiles_scrollTo(uint16_t y)
+{
+	// Move the view so that map row y is at the top of the screen (limited to the
+	// map).  The display scrolls in hardware; only the rows coming into view are
+	// drawn, along with any sprites on them.
+	uint16_t Limit, First, Rows;
+	Limit = (MapRows * TILE_SIZE > VIEW_HEIGHT) ? MapRows * TILE_SIZE - VIEW_HEIGHT : 0;
+	if (y > Limit)
+		y = Limit;
+	if (y == ViewY)
+		return;
+	if (y > ViewY)
+	{
+		Rows = y - ViewY;
+		First = ViewY + VIEW_HEIGHT;
+		ViewLine += Rows % VIEW_HEIGHT;
+	}
+	else
+	{
+		Rows = ViewY - y;
+		First = y;
+		ViewLine += VIEW_HEIGHT - (Rows % VIEW_HEIGHT);
+	}
+	if (ViewLine >= VIEW_HEIGHT)
+		ViewLine -= VIEW_HEIGHT;
+	ViewY = y;
+	if (Rows >= VIEW_HEIGHT)
+	{
+		// nothing on the screen can be kept
+		tiles_drawAll();
+		return;
+	}
+	display_scrollTo(ViewLine);
+	composeClipped(0, First, MAP_WIDTH, Rows, Sprites, TILES_MAX_SPRITES);
+}
+uint16_t tiles_getView()
+{
+	return ViewY;
+}
+void tiles_moveSprite(uint16_t Slot, uint16_t x, uint16_t y, const PalImage *Image, int hOrientation, int vOrientation, int Transpose)
+{
+	// Place (or keep) a sprite in one of the slots.  Slots are drawn in order, so
+	// higher numbered sprites end up on top.  Nothing is sent to the display here;
+	// tiles_render redraws the sprites that changed.
+	TileSprite *Sprite = &Sprites[Slot];
+	hOrientation = (hOrientation != 0);
+	vOrientation = (vOrientation != 0);
+	Transpose = (Transpose != 0);
+	if ((Sprite->Shown) && (Sprite->x == x) && (Sprite->y == y) && (Sprite->Pal == Image)
+		&& (Sprite->hOrientation == hOrientation) && (Sprite->vOrientation == vOrientation)
+		&& (Sprite->Transposed == Transpose) && (Sprite->Scale == 1))
+		return;
+	if (Transpose)
+		setSprite(Sprite, x, y, Image->Height, Image->Width, Image, hOrientation, vOrientation, 1);
+	else
+		setSprite(Sprite, x, y, Image->Width, Image->Height, Image, hOrientation, vOrientation, 0);
+	Sprite->Changed = 1;
+}
+void tiles_moveSpriteScaled(uint16_t Slot, uint16_t x, uint16_t y, const PalImage *Image, uint16_t Scale)
+{
+	// tiles_moveSprite for an image shown Scale times its size.  Nothing bigger is
+	// stored: each image pixel is repeated across and down as the rows are composed.
+	TileSprite *Sprite = &Sprites[Slot];
+	if ((Sprite->Shown) && (Sprite->x == x) && (Sprite->y == y) && (Sprite->Pal == Image)
+		&& (Sprite->Scale == Scale))
+		return;
+	setSprite(Sprite, x, y, Image->Width * Scale, Image->Height * Scale, Image, 0, 0, 0);
+	Sprite->Scale = Scale;
+	Sprite->Changed = 1;
+}
+void tiles_hideSprite(uint16_t Slot)
+{
+	TileSprite *Sprite = &Sprites[Slot];
+	if (Sprite->Shown)
+	{
+		Sprite->Shown = 0;
+		Sprite->Changed = 1;
+	}
+}
+void tiles_clearSprites()
+{
+	// Empty every slot without drawing anything, for when the screen is about to be
+	// redrawn anyway
+	uint16_t i;
+	for (i = 0; i < TILES_MAX_SPRITES; i++)
+	{
+		Sprites[i].Shown = 0;
+		Sprites[i].OnScreen = 0;
+		Sprites[i].Changed = 0;
+	}
+}
+uint16_t tiles_render()
+{
+	// Bring the screen up to date: each sprite that moved is redrawn with a single
+	// write covering its old and new positions, along with whatever other sprites
+	// cover them.  Returns the number of sprites redrawn.
+	uint16_t i, Redrawn = 0;
+	TileSprite *Sprite;
+	for (i = 0; i < TILES_MAX_SPRITES; i++)
+	{
+		Sprite = &Sprites[i];
+		if (Sprite->Changed)
+		{
+			if (Sprite->OnScreen)
+				composeUnion(Sprite);
+			else if (Sprite->Shown)
+				composeClipped(Sprite->x, Sprite->y, Sprite->w, Sprite->h, Sprites, TILES_MAX_SPRITES);
+			Sprite->OnScreen = Sprite->Shown;
+			Sprite->ox = Sprite->x;
+			Sprite->oy = Sprite->y;
+			Sprite->ow = Sprite->w;
+			Sprite->oh = Sprite->h;
+			Sprite->Changed = 0;
+			Redrawn++;
+		}
+	}
+	return Redrawn;
+}
+static void composeUnion(const TileSprite *Sprite)
+{
+	// Redraw a sprite that was on screen at ox,oy: one rectangle covering both
+	// positions clears the old pixels and draws the new ones in a single pass.
+	// Positions far apart are drawn as two rectangles instead.
+	uint16_t x0, y0, x1, y1;
+	if (Sprite->Shown == 0)
+	{
+		composeClipped(Sprite->ox, Sprite->oy, Sprite->ow, Sprite->oh, Sprites, TILES_MAX_SPRITES);
+		return;
+	}
+	x0 = (Sprite->x < Sprite->ox) ? Sprite->x : Sprite->ox;
+	y0 = (Sprite->y < Sprite->oy) ? Sprite->y : Sprite->oy;
+	x1 = (Sprite->x + Sprite->w > Sprite->ox + Sprite->ow) ? Sprite->x + Sprite->w : Sprite->ox + Sprite->ow;
+	y1 = (Sprite->y + Sprite->h > Sprite->oy + Sprite->oh) ? Sprite->y + Sprite->h : Sprite->oy + Sprite->oh;
+	if ((uint32_t)(x1 - x0) * (y1 - y0) <= (uint32_t)Sprite->w * Sprite->h + (uint32_t)Sprite->ow * Sprite->oh)
+	{
+		composeClipped(x0, y0, x1 - x0, y1 - y0, Sprites, TILES_MAX_SPRITES);
+	}
+	else
+	{
+		composeClipped(Sprite->ox, Sprite->oy, Sprite->ow, Sprite->oh, Sprites, TILES_MAX_SPRITES);
+		composeClipped(Sprite->x, Sprite->y, Sprite->w, Sprite->h, Sprites, TILES_MAX_SPRITES);
+	}
+}
+static void composeRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Line, const TileSprite *List, uint16_t Count)
+{
+	// Build the rectangle one pixel row at a time in RowBuffer - the tile colours
+	// first, then the sprites in order - and send it through a single aperture
+	// starting at frame memory row Line.  The rectangle must lie on the map, be no
+	// wider than RowBuffer and not wrap around the bottom of frame memory.
+	uint16_t row, px, i, n, Colour;
+	const uint8_t *MapRow;
+	openAperture(x, Line, x + w - 1, Line + h - 1);
+	for (row = y; row < y + h; row++)
+	{
+		MapRow = TileMap[row / TILE_SIZE];
+		for (px = x; px < x + w; px += n)
+		{
+			// fill up to the end of this tile
+			n = TILE_SIZE - (px % TILE_SIZE);
+			if (n > x + w - px)
+				n = x + w - px;
+			Colour = TileColours[MapRow[px / TILE_SIZE] == 1];
+			for (i = 0; i < n; i++)
+				RowBuffer[px - x + i] = Colour;
+		}
+		for (i = 0; i < Count; i++)
+			overlaySprite(&List[i], x, w, row);
+		display_writePixels(RowBuffer, w);
+	}
+}
+static void overlaySprite(const TileSprite *Sprite, uint16_t x0, uint16_t w, uint16_t y)
+{
+	// Copy the part of one sprite row that falls inside RowBuffer (screen x0 to x0+w-1),
+	// leaving the background showing through transparent pixels
+	const uint8_t *PalRow;
+	uint16_t sy, xa, xb, sx, Colour, Stride, Shift, n, i;
+	if ((Sprite->Shown == 0) || (y < Sprite->y) || (y >= Sprite->y + Sprite->h))
+		return;
+	xa = (Sprite->x > x0) ? Sprite->x : x0;
+	xb = (Sprite->x + Sprite->w < x0 + w) ? Sprite->x + Sprite->w : x0 + w;
+	if (xa >= xb)
+		return;
+	sy = y - Sprite->y;
+	if (Sprite->vOrientation)
+		sy = Sprite->h - 1 - sy;
+	if (Sprite->Scale > 1)
+	{
+		// image row sy / Scale, each pixel of it copied into Scale buffer entries
+		// (fewer for the first one if the sprite starts left of the buffer)
+		PalRow = &Sprite->Pal->Pixels[(sy / Sprite->Scale) * ((Sprite->Pal->Width + 1) / 2)];
+		sx = (xa - Sprite->x) / Sprite->Scale;
+		n = Sprite->Scale - (xa - Sprite->x - sx * Sprite->Scale);
+		for (; xa < xb; sx++)
+		{
+			if (n > xb - xa)
+				n = xb - xa;
+			if (sx & 1)
+				Colour = PalRow[sx >> 1] & 0x0f;
+			else
+				Colour = PalRow[sx >> 1] >> 4;
+			if (Colour != 0)
+			{
+				Colour = Sprite->Pal->Palette[Colour];
+				for (i = 0; i < n; i++)
+					RowBuffer[xa - x0 + i] = Colour;
+			}
+			xa += n;
+			n = Sprite->Scale;
+		}
+		return;
+	}
+	if (Sprite->Transposed)
+	{
+		// this screen row is image column sy, read a nibble from each image row
+		// in turn, Stride bytes apart
+		Stride = (Sprite->h + 1) / 2;
+		Shift = (sy & 1) ? 0 : 4;
+		PalRow = &Sprite->Pal->Pixels[sy >> 1];
+		for (; xa < xb; xa++)
+		{
+			sx = xa - Sprite->x;
+			if (Sprite->hOrientation)
+				sx = Sprite->w - 1 - sx;
+			Colour = (PalRow[sx * Stride] >> Shift) & 0x0f;
+			if (Colour != 0)
+				RowBuffer[xa - x0] = Sprite->Pal->Palette[Colour];
+		}
+		return;
+	}
+	// palette index 0 is the transparent one
+	PalRow = &Sprite->Pal->Pixels[sy * ((Sprite->w + 1) / 2)];
+	if ((Sprite->w == 12) && (xa == Sprite->x) && (xb == Sprite->x + 12))
+	{
+		// every sprite in the game is 12 wide, the whole row is in the buffer
+		if (Sprite->hOrientation)
+			overlayPal12Mirrored(&RowBuffer[xa - x0], PalRow, Sprite->Pal->Palette);
+		else
+			overlayPal12(&RowBuffer[xa - x0], PalRow, Sprite->Pal->Palette);
+		return;
+	}
+	for (; xa < xb; xa++)
+	{
+		sx = xa - Sprite->x;
+		if (Sprite->hOrientation)
+			sx = Sprite->w - 1 - sx;
+		if (sx & 1)
+			Colour = PalRow[sx >> 1] & 0x0f;
+		else
+			Colour = PalRow[sx >> 1] >> 4;
+		if (Colour != 0)
+			RowBuffer[xa - x0] = Sprite->Pal->Palette[Colour];
+	}
+}
+static void setSprite(TileSprite *Sprite, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const PalImage *Pal, int hOrientation, int vOrientation, int Transpose)
+{
+	// w and h are the size on the screen, so swapped for a transposed image
+	Sprite->x = x;
+	Sprite->y = y;
+	Sprite->w = w;
+	Sprite->h = h;
+	Sprite->Pal = Pal;
+	Sprite->hOrientation = (hOrientation != 0);
+	Sprite->vOrientation = (vOrientation != 0);
+	Sprite->Transposed = (Transpose != 0);
+	Sprite->Scale = 1;
+	Sprite->Shown = 1;
+}
+static void composeClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const TileSprite *List, uint16_t Count)
+{
+	// Clip a rectangle to the screen and compose it in strips no wider than
+	// RowBuffer, split in two where it wraps around the bottom of frame memory
+	uint16_t n, Line, Above;
+	if ((x >= MAP_WIDTH) || (clipView(&y, &h) == 0))
+		return;
+	if (x + w > MAP_WIDTH)
+		w = MAP_WIDTH - x;
+	Line = viewLine(y);
+	Above = (h > VIEW_HEIGHT - Line) ? VIEW_HEIGHT - Line : h;
+	while (w > 0)
+	{
+		n = (w > ROW_BUFFER_SIZE) ? ROW_BUFFER_SIZE : w;
+		composeRect(x, y, n, Above, Line, List, Count);
+		if (Above < h)
+			composeRect(x, y + Above, n, h - Above, 0, List, Count);
+		x += n;
+		w -= n;
+	}
+}
+static int clipView(uint16_t *y, uint16_t *h)
+{
+	// Trim rows y to y+h-1 to the ones on the screen, returns 0 if none are
+	if ((*h == 0) || (*y >= ViewY + VIEW_HEIGHT) || (*y + *h <= ViewY))
+		return 0;
+	if (*y < ViewY)
+	{
+		*h -= ViewY - *y;
+		*y = ViewY;
+	}
+	if (*y + *h > ViewY + VIEW_HEIGHT)
+		*h = ViewY + VIEW_HEIGHT - *y;
+	return 1;
+}
+static uint16_t viewLine(uint16_t y)
+{
+	// Frame memory row holding map row y, which must be on the screen
+	uint16_t Line = ViewLine + (y - ViewY);
+	if (Line >= VIEW_HEIGHT)
+		Line -= VIEW_HEIGHT;
+	return Line;
+}
@@ -0,0 +1,25 @@
+#include <stdint.h>
+// Tile map renderer: the playfield is a grid of solid colour tiles with sprites on top.
+// Sprites live in numbered slots; tiles_render redraws only the sprites that changed.
+// Maps can be taller than the screen and are scrolled with the display's hardware
+// vertical scrolling.  Coordinates are map coordinates.
+#define TILE_SIZE 8
+#define TILE_COLS 16
+#define TILE_ROWS 19           // rows on the screen, the 8 lines below them are left for the HUD
+#define TILES_MAX_ROWS 32      // rows in the tallest map
+#define TILES_MAX_SPRITES 12
+
+void tiles_setMap(const uint8_t (*Map)[TILE_COLS], uint16_t Rows, uint16_t PathColour, uint16_t WallColour);
+void tiles_setColours(uint16_t PathColour, uint16_t WallColour);
+void tiles_drawAll(void);
+void tiles_drawArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void tiles_scrollTo(uint16_t y);
+uint16_t tiles_getView(void);
+// Transpose swaps the image's rows and columns before any flip, so an image facing
+// right faces left with hOrientation, down with Transpose and up with Transpose
+// and vOrientation.
+void tiles_moveSprite(uint16_t Slot, uint16_t x, uint16_t y, const PalImage *Image, int hOrientation, int vOrientation, int Transpose);
+void tiles_moveSpriteScaled(uint16_t Slot, uint16_t x, uint16_t y, const PalImage *Image, uint16_t Scale);
+void tiles_hideSprite(uint16_t Slot);
+void tiles_clearSprites(void);
+uint16_t tiles_render(void);
@@ -0,0 +1,99 @@
+#include <stdint.h>
+#include "display.h"
+#include "transition.h"
+#define DISSOLVE_CELL 4   // dissolve cell size in pixels
+
+// Order in which the cells of each 4x4 block of the dissolve come in
+static const uint8_t Bayer[4][4] = {
+	{0, 8, 2, 10},
+	{12, 4, 14, 6},
+	{3, 11, 1, 9},
+	{15, 7, 13, 5}
+};
+
+static TransitionDraw Draw;
+static uint8_t Type;
+static uint8_t Step;        // next step to draw, TRANSITION_STEPS once the new screen is complete
+static uint8_t Active;
+static uint32_t Hold;       // time the finished screen is left before the transition ends
+static uint32_t StepTime;   // time the last step was drawn
+
+static void drawStep(void);
+static void drawClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+void transition_start(uint8_t NewType, TransitionDraw NewDraw, uint32_t NewHold, uint32_t Now)
+{
+	// Start replacing the screen with the one drawn by NewDraw.  The first step is
+	// drawn by the next transition_poll.
+	Type = NewType;
+	Draw = NewDraw;
+	Hold = NewHold;
+	Step = 0;
+	StepTime = Now - TRANSITION_STEP_MS;
+	Active = 1;
+}
+int transition_poll(uint32_t Now)
+{
+	// Draw the next step if it is due, returns 1 until the new screen is complete and
+	// has been held.  A late call draws only one step, so each call costs at most one.
+	if (Active == 0)
+		return 0;
+	if (Step < TRANSITION_STEPS)
+	{
+		if (Now - StepTime >= TRANSITION_STEP_MS)
+		{
+			drawStep();
+			Step++;
+			StepTime = Now;
+		}
+		return 1;
+	}
+	if (Now - StepTime < Hold)
+		return 1;
+	Active = 0;
+	return 0;
+}
+int transition_active()
+{
+	return Active;
+}
+static void drawStep()
+{
+	// Each pixel of the screen is drawn by exactly one step
+	uint16_t x, y, bx = 0, by = 0, Band;
+	switch (Type)
+	{
+		case TRANSITION_WIPE:
+			Band = (SCREEN_WIDTH + TRANSITION_STEPS - 1) / TRANSITION_STEPS;
+			drawClipped(Step * Band, 0, Band, SCREEN_HEIGHT);
+			break;
+		case TRANSITION_BLINDS:
+			// bands TRANSITION_STEPS rows high, one more row of each per step
+			for (y = Step; y < SCREEN_HEIGHT; y += TRANSITION_STEPS)
+				drawClipped(0, y, SCREEN_WIDTH, 1);
+			break;
+		default:
+			for (y = 0; y < 4; y++)
+				for (x = 0; x < 4; x++)
+					if (Bayer[y][x] == Step)
+					{
+						bx = x;
+						by = y;
+					}
+			for (y = by * DISSOLVE_CELL; y < SCREEN_HEIGHT; y += 4 * DISSOLVE_CELL)
+				for (x = bx * DISSOLVE_CELL; x < SCREEN_WIDTH; x += 4 * DISSOLVE_CELL)
+					drawClipped(x, y, DISSOLVE_CELL, DISSOLVE_CELL);
+			break;
+	}
+}
+static void drawClipped(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	// Draw an area of the new screen, trimmed to the screen
+	if ((x >= SCREEN_WIDTH) || (y >= SCREEN_HEIGHT))
+		return;
+	if (x + w > SCREEN_WIDTH)
+		w = SCREEN_WIDTH - x;
+	if (y + h > SCREEN_HEIGHT)
+		h = SCREEN_HEIGHT - y;
+	Draw(x, y, w, h);
+}
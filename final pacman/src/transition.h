@@ -0,0 +1,16 @@
+#include <stdint.h>
+// Screen transitions: the new screen replaces the old one a piece at a time, one step
+// every TRANSITION_STEP_MS, drawn by transition_poll from the main loop.  The new
+// screen comes from a callback that draws any area of it, so only the pixels that
+// change are sent and nothing of either screen is held in RAM.
+#define TRANSITION_WIPE 0       // columns from left to right
+#define TRANSITION_BLINDS 1     // bands across the screen, all opening downwards together
+#define TRANSITION_DISSOLVE 2   // small cells in ordered dither order
+#define TRANSITION_STEPS 16
+#define TRANSITION_STEP_MS 20
+
+typedef void (*TransitionDraw)(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+void transition_start(uint8_t Type, TransitionDraw Draw, uint32_t Hold, uint32_t Now);
+int transition_poll(uint32_t Now);
+int transition_active(void);